@@ -0,0 +1,32 @@
+# Benchmark runner for the SMBIOS parser (see smbios_bench.h); Linux only
+CONFIG += c++17 console
+CONFIG -= app_bundle qt
+TARGET = smbios-bench
+
+SOURCES += \
+        bench_main.cpp \
+        smbios.cpp \
+        smbios_decode.cpp \
+        smbios_topology.cpp \
+        smbios_strings.cpp \
+        smbios_core.cpp \
+        smbios_bulk.cpp \
+        smbios_index.cpp \
+        smbios_archive.cpp \
+        smbios_stream.cpp \
+        smbios_bench.cpp
+
+HEADERS += \
+        smbios.h \
+        smbios_decode.h \
+        smbios_names.h \
+        smbios_topology.h \
+        smbios_strings.h \
+        smbios_core.h \
+        smbios_bulk.h \
+        smbios_index.h \
+        smbios_archive.h \
+        smbios_stream.h \
+        smbios_bench.h
+
+LIBS += -lz
@@ -1,6 +1,6 @@
 QT -= gui
 QT += websockets
-CONFIG += c++11 console
+CONFIG += c++17 console
 CONFIG -= app_bundle
 
 # You can make your code fail to compile if it uses deprecated APIs.
@@ -11,7 +11,11 @@ SOURCES += \
         echoclient.cpp \
 		smbios.cpp \
 		smbios_decode.cpp \
-        main.cpp
+        main.cpp \
+        smbios_topology.cpp \
+        smbios_strings.cpp \
+        smbios_core.cpp \
+        smbios_stream.cpp
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -21,5 +25,17 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 HEADERS += \
     echoclient.h \
 	smbios.h \
-	smbios_decode.h
+	smbios_decode.h \
+	smbios_names.h \
+	smbios_topology.h \
+	smbios_strings.h \
+	smbios_core.h \
+	smbios_stream.h
 	
+
+# Linux-only batch tooling
+unix {
+    SOURCES += smbios_archive.cpp smbios_bulk.cpp smbios_index.cpp
+    HEADERS += smbios_archive.h smbios_bulk.h smbios_index.h
+    LIBS += -lz
+}
@@ -0,0 +1,28 @@
+# SMBIOS inventory collector for constrained environments (initramfs, rescue
+# shells). The default build is the heap-free core (see smbios_core.h): no
+# exceptions, no RTTI, no iostreams. 'qmake CONFIG+=full' builds the same
+# collector on getDMI/printSMBIOS instead, to compare against.
+CONFIG += c++17 console
+CONFIG -= app_bundle qt
+
+SOURCES += \
+        collect_main.cpp \
+        smbios.cpp \
+        smbios_strings.cpp \
+        smbios_core.cpp
+
+HEADERS += \
+        smbios.h \
+        smbios_names.h \
+        smbios_strings.h \
+        smbios_core.h
+
+full {
+    TARGET = smbios-collect-full
+    SOURCES += smbios_decode.cpp
+    HEADERS += smbios_decode.h
+} else {
+    TARGET = smbios-collect
+    DEFINES += SMBIOS_CORE
+    CONFIG += exceptions_off rtti_off
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#include "smbios.h"
+#include "smbios_bench.h"
+#include "smbios_decode.h"
+
+/*
+ * Command line of the benchmark runner (see 'smbios_bench.h'):
+ *
+ *   smbios-bench [-i iterations] [-s stage,...] [--no-counters] [dump...]
+ *
+ * The stages run over synthetic tables of 2 to 128 sockets, a 2 socket one
+ * whose strings all need sanitizing, and over each dump given: a file in any
+ * layout 'Parser' detects, or a directory laid out as /sys/firmware/dmi/tables
+ * (read with 'getDMI'). Without dumps, the tables of the running system are
+ * used when they are readable.
+ *
+ *   smbios-bench startup [-r runs] [-d dump-directory] collector...
+ *
+ * Size and startup-to-output latency of collectors built from
+ * MalwareCollector.pro (the core build and the CONFIG+=full one).
+ *
+ *   smbios-bench loader [-n files] [-t temp-dir] [dump]
+ *
+ * Files per second of 'getDMI' against 'BulkReader' (pread and io_uring) on
+ * that many copies of the dump (1M copies of the 2 socket synthetic table by
+ * default; the dumps take about 16 GB of disk while the run lasts).
+ *
+ *   smbios-bench index [-n tables] [-q queries] [-t temp-dir]
+ *
+ * Build time, file size and query latency of an 'Index' over that many synthetic
+ * machines (1M by default, the corpus size the index is meant for).
+ *
+ *   smbios-bench ingest [-n archives] [-m tables] [-d threads] [-p threads] [-t temp-dir]
+ *
+ * Per-stage throughput and bottleneck of 'ingestArchives' over .tar.gz
+ * archives of synthetic machines in the sysfs layout (the decompress and parse
+ * thread counts default to those of 'IngestOptions').
+ *
+ *   smbios-bench stream [dump...]
+ *
+ * Test that 'StreamParser' decodes the synthetic tables and the dumps given
+ * the same as 'Parser' over the whole buffer, whatever the chunk sizes; the
+ * exit status is 1 on any mismatch.
+ */
+
+static const char *DMI_TABLES_PATH = "/sys/firmware/dmi/tables";
+
+static int usage()
+{
+    std::cerr << "usage: smbios-bench [-i iterations] [-s stage,...] [--no-counters] [dump...]\n"
+        "       smbios-bench startup [-r runs] [-d dump-directory] collector...\n"
+        "       smbios-bench loader [-n files] [-t temp-dir] [dump]\n"
+        "       smbios-bench index [-n tables] [-q queries] [-t temp-dir]\n"
+        "       smbios-bench ingest [-n archives] [-m tables] [-d threads] [-p threads] [-t temp-dir]\n"
+        "       smbios-bench stream [dump...]\n"
+        "stages:";
+    for (int stage = 0; stage < smbios::BENCH_STAGES; ++stage)
+        std::cerr << ' ' << smbios::benchStageName(stage);
+    std::cerr << std::endl;
+    return 1;
+}
+
+static bool readFile( const std::string &path, std::vector<uint8_t> &buffer )
+{
+    std::ifstream input(path.c_str(), std::ios_base::binary);
+    if (!input.good()) return false;
+    buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    return !input.bad();
+}
+
+static bool loadDump( const std::string &path, smbios::BenchTable &table )
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return false;
+    // the report has little room for the name
+    size_t pos = path.find_last_of('/', path.size() - 2);
+    table.name = (pos == std::string::npos) ? path : path.substr(pos + 1);
+    if (S_ISDIR(info.st_mode)) return getDMI(path, table.data);
+    return readFile(path, table.data);
+}
+
+// parses a comma separated list of stage names into a mask (0 on error)
+static uint32_t parseStages( const char *list )
+{
+    uint32_t stages = 0;
+    std::string names(list);
+    size_t pos = 0;
+    while (pos <= names.size())
+    {
+        size_t end = names.find(',', pos);
+        if (end == std::string::npos) end = names.size();
+        int stage = smbios::benchStage(names.substr(pos, end - pos).c_str());
+        if (stage == smbios::BENCH_STAGES) return 0;
+        stages |= 1U << stage;
+        pos = end + 1;
+    }
+    return stages;
+}
+
+static void addSyntheticTables( std::vector<smbios::BenchTable> &tables )
+{
+    // many-socket tables show how the per-structure stages (topology above all) scale
+    static const int SOCKETS[] = { 2, 8, 32, 128 };
+    smbios::BenchTable table;
+    for (size_t i = 0; i < sizeof(SOCKETS) / sizeof(SOCKETS[0]); ++i)
+    {
+        table.name = "synthetic-" + std::to_string(SOCKETS[i]) + "s";
+        smbios::makeSyntheticTable(SOCKETS[i], SOCKETS[i] * 8, table.data);
+        tables.push_back(table);
+    }
+    table.name = "synthetic-dirty";
+    smbios::makeSyntheticTable(2, 16, table.data, true);
+    tables.push_back(table);
+}
+
+static int runStartup( int argc, char **argv )
+{
+    size_t runs = 200;
+    std::string dumps;
+    std::vector<std::string> collectors;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            runs = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            dumps = argv[++i];
+        else
+        if (argv[i][0] == '-')
+            return usage();
+        else
+            collectors.push_back(argv[i]);
+    }
+    if (runs == 0 || collectors.empty()) return usage();
+
+    std::vector<smbios::StartupResult> results;
+    for (size_t i = 0; i < collectors.size(); ++i)
+    {
+        std::vector<std::string> command;
+        command.push_back(collectors[i]);
+        if (!dumps.empty()) command.push_back(dumps);
+
+        smbios::StartupResult result;
+        if (!smbios::measureStartup(command, runs, result))
+        {
+            std::cerr << "Unable to run " << collectors[i] << std::endl;
+            return 1;
+        }
+        results.push_back(result);
+    }
+    smbios::printStartup(results, std::cout);
+    return 0;
+}
+
+static int runLoader( int argc, char **argv )
+{
+    size_t files = 1000000;
+    std::string directory = "/tmp";
+    std::string dump;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            files = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            directory = argv[++i];
+        else
+        if (argv[i][0] == '-' || !dump.empty())
+            return usage();
+        else
+            dump = argv[i];
+    }
+    if (files == 0) return usage();
+
+    smbios::BenchTable table;
+    if (dump.empty())
+        smbios::makeSyntheticTable(2, 16, table.data);
+    else
+    if (!loadDump(dump, table))
+    {
+        std::cerr << "Unable to read " << dump << std::endl;
+        return 1;
+    }
+
+    std::vector<smbios::LoaderResult> results;
+    if (!smbios::measureLoaders(table.data, files, directory, results))
+    {
+        std::cerr << "Unable to write the dumps to " << directory << std::endl;
+        return 1;
+    }
+    smbios::printLoaders(results, std::cout);
+    return 0;
+}
+
+static int runIndex( int argc, char **argv )
+{
+    size_t tables = 1000000;
+    size_t queries = 10000;
+    std::string directory = "/tmp";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            tables = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-q") == 0 && i + 1 < argc)
+            queries = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            directory = argv[++i];
+        else
+            return usage();
+    }
+    if (tables == 0 || queries == 0) return usage();
+
+    smbios::IndexResult result;
+    if (!smbios::measureIndex(tables, queries, directory, result))
+    {
+        std::cerr << "Unable to build or query the index in " << directory << std::endl;
+        return 1;
+    }
+    smbios::printIndex(result, std::cout);
+    return 0;
+}
+
+static int runIngest( int argc, char **argv )
+{
+    size_t archives = 64;
+    size_t tables = 1000;
+    std::string directory = "/tmp";
+    smbios::IngestOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            archives = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+            tables = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            options.decompressThreads = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+            options.parseThreads = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            directory = argv[++i];
+        else
+            return usage();
+    }
+    if (archives == 0 || tables == 0 || options.decompressThreads == 0 || options.parseThreads == 0) return usage();
+
+    smbios::IngestStats stats;
+    bool ok = smbios::measureIngest(archives, tables, directory, options, stats);
+    smbios::printIngestStats(stats, std::cout);
+    if (!ok)
+    {
+        std::cerr << "Unable to write or ingest the archives in " << directory << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+static int runStream( int argc, char **argv )
+{
+    std::vector<smbios::BenchTable> tables;
+    addSyntheticTables(tables);
+    smbios::BenchTable table;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i][0] == '-') return usage();
+        if (!loadDump(argv[i], table))
+        {
+            std::cerr << "Unable to read " << argv[i] << std::endl;
+            return 1;
+        }
+        tables.push_back(table);
+    }
+    return smbios::checkStream(tables, std::cout) ? 0 : 1;
+}
+
+static int runStages( int argc, char **argv )
+{
+    smbios::BenchOptions options;
+    std::vector<std::string> dumps;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            options.iterations = (size_t) strtoul(argv[++i], NULL, 10);
+        else
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            options.stages = parseStages(argv[++i]);
+            if (options.stages == 0) return usage();
+        }
+        else
+        if (strcmp(argv[i], "--no-counters") == 0)
+            options.counters = false;
+        else
+        if (argv[i][0] == '-')
+            return usage();
+        else
+            dumps.push_back(argv[i]);
+    }
+    if (options.iterations == 0) return usage();
+
+    std::vector<smbios::BenchTable> tables;
+    smbios::BenchTable table;
+    addSyntheticTables(tables);
+
+    if (dumps.empty())
+    {
+        // the system tables are only readable by root
+        if (loadDump(DMI_TABLES_PATH, table))
+        {
+            table.name = "system";
+            tables.push_back(table);
+        }
+        else
+            std::cerr << "Unable to open SMBIOS tables from " << DMI_TABLES_PATH << ", using synthetic tables only" << std::endl;
+    }
+    for (size_t i = 0; i < dumps.size(); ++i)
+    {
+        if (!loadDump(dumps[i], table))
+        {
+            std::cerr << "Unable to read " << dumps[i] << std::endl;
+            return 1;
+        }
+        tables.push_back(table);
+    }
+
+    std::vector<smbios::BenchResult> results;
+    std::string counterError;
+    bool valid = smbios::runBenchmark(tables, options, results, &counterError);
+    if (options.counters && !counterError.empty())
+        std::cout << "Hardware counters unavailable (" << counterError << "), wall clock only\n";
+    smbios::printBenchmark(results, std::cout);
+    if (!valid) std::cerr << "Some tables are not valid SMBIOS data" << std::endl;
+    return valid ? 0 : 1;
+}
+
+int main( int argc, char **argv )
+{
+    if (argc > 1 && strcmp(argv[1], "startup") == 0) return runStartup(argc - 1, argv + 1);
+    if (argc > 1 && strcmp(argv[1], "loader") == 0) return runLoader(argc - 1, argv + 1);
+    if (argc > 1 && strcmp(argv[1], "index") == 0) return runIndex(argc - 1, argv + 1);
+    if (argc > 1 && strcmp(argv[1], "ingest") == 0) return runIngest(argc - 1, argv + 1);
+    if (argc > 1 && strcmp(argv[1], "stream") == 0) return runStream(argc - 1, argv + 1);
+    return runStages(argc, argv);
+}
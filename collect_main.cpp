@@ -0,0 +1,115 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "smbios.h"
+#include "smbios_core.h"
+
+#ifdef SMBIOS_CORE
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#endif
+#else
+#include <iostream>
+#include <vector>
+#include "smbios_decode.h"
+#endif
+
+/*
+ * Inventory collector: prints the SMBIOS tables of the running system (on
+ * Linux, optionally those of the directory given, laid out as
+ * /sys/firmware/dmi/tables) in the 'printSMBIOS' format.
+ *
+ * The default build (MalwareCollector.pro) is the core one: SMBIOS_CORE,
+ * no exceptions, no RTTI, no heap and no iostreams. With CONFIG+=full the
+ * same collector goes through 'getDMI' and 'printSMBIOS' instead, which is
+ * what 'smbios-bench startup' compares it against.
+ */
+
+#ifdef SMBIOS_CORE
+
+// large enough for any table firmware hands out in practice
+static uint8_t table[256 * 1024];
+
+static void writeOutput( void *context, const char *data, size_t size )
+{
+    bool &failed = *(bool*) context;
+    while (size > 0 && !failed)
+    {
+        #ifdef _WIN32
+        int count = _write(1, data, (unsigned) size);
+        #else
+        ssize_t count = write(1, data, size);
+        if (count < 0 && errno == EINTR) continue;
+        #endif
+        if (count <= 0)
+            failed = true;
+        else
+        {
+            data += count;
+            size -= (size_t) count;
+        }
+    }
+}
+
+int main( int argc, char **argv )
+{
+    #ifdef _WIN32
+    (void) argc;
+    (void) argv;
+    size_t size = smbios::readDMI(table, sizeof(table));
+    #else
+    size_t size = smbios::readDMI((argc == 2) ? argv[1] : "/sys/firmware/dmi/tables", table, sizeof(table));
+    #endif
+    if (size == 0) return 1;
+
+    smbios::Parser parser(table, size);
+    if (!parser.valid()) return 1;
+
+    bool failed = false;
+    smbios::ByteSink sink = { writeOutput, &failed };
+    smbios::emitSMBIOS(parser, sink);
+    return failed ? 1 : 0;
+}
+
+#else
+
+int main( int argc, char **argv )
+{
+    std::vector<uint8_t> buffer;
+    #ifdef _WIN32
+    (void) argc;
+    (void) argv;
+    bool result = getDMI(buffer);
+    #else
+    bool result = getDMI((argc == 2) ? argv[1] : "/sys/firmware/dmi/tables", buffer);
+    #endif
+    if (!result) return 1;
+
+    smbios::Parser parser(buffer.data(), buffer.size());
+    if (!parser.valid()) return 1;
+
+    printSMBIOS(parser, std::cout);
+    std::cout.flush();
+    return std::cout.good() ? 0 : 1;
+}
+
+#endif
@@ -174,7 +174,7 @@ QJsonObject EchoClient::fromStringToJsonObject(const QString &out)
 	QStringList outList = out.split(QLatin1Char('\n'), QString::SkipEmptyParts);
 	
 	QStringList sections = {"bios", "sysinfo", "baseboard",
-							"sysenclosure", "processor", "sysslot",
+							"sysenclosure", "processor", "cache", "sysslot",
 							"physmem", "memory", "oemstrings"};
 	
 	for (const auto& section : sections) {
@@ -188,20 +188,20 @@ QJsonObject EchoClient::fromStringToJsonObject(const QString &out)
 		{
 			QString value = elemList.mid(1).join(':');
 			
-			int sectionIndex = -1;
 			int valueIndex = 0;
 			
-			for (int i = 0; i < sections.length(); i++) {
-				if (elemList[0].contains(sections[i])) {
-					sectionIndex = i;
-				}
+			// the section is the exact "[name] " prefix, a key that merely contains another section name must not select it
+			int sectionIndex = -1;
+			int sectionEnd = elemList[0].indexOf("] ");
+			if (elemList[0].startsWith('[') && sectionEnd > 1) {
+				sectionIndex = sections.indexOf(elemList[0].mid(1, sectionEnd - 1));
 			}
 			
 			if (sectionIndex == -1) {
 				break;
 			}
 
-			QString key = elemList[0].replace("[" + sections[sectionIndex] + "] " , "");
+			QString key = elemList[0].mid(sectionEnd + 2);
 			
 			QJsonArray array = recordObject[sections[sectionIndex]].toArray();
 			
@@ -16,101 +16,157 @@
  */
 
 #include "smbios.h"
-#include <vector>
-#include <stdio.h>
 
-#define DMI_READ_8U    *ptr_++
-#define DMI_READ_16U   *((uint16_t*)ptr_), ptr_ += 2
-#define DMI_READ_32U   *((uint32_t*)ptr_), ptr_ += 4
-#define DMI_READ_64U   *((uint64_t*)ptr_), ptr_ += 8
+#define DMI_READ_8U    read<uint8_t>()
+#define DMI_READ_16U   read<uint16_t>()
+#define DMI_READ_32U   read<uint32_t>()
+#define DMI_READ_64U   read<uint64_t>()
 #define DMI_ENTRY_HEADER_SIZE   4
 
 namespace smbios {
 
-#ifdef _WIN32
+#define DMI_ENTRY_POINT_SIZE    32
+#define DMI_RAW_HEADER_SIZE     8
 
-#include <Windows.h>
+static bool isEntryPoint( const uint8_t *data, size_t size )
+{
+    if (size < DMI_ENTRY_POINT_SIZE) return false;
+    return (data[0] == '_' && data[1] == 'S' && data[2] == 'M' && data[3] == '_') ||
+        (data[0] == '_' && data[1] == 'S' && data[2] == 'M' && data[3] == '3' && data[4] == '_');
+}
 
-struct RawSMBIOSData
+/*
+ * The 'RawSMBIOSData' header is
+ *
+ *   BYTE Used20CallingMethod, SMBIOSMajorVersion, SMBIOSMinorVersion, DmiRevision
+ *   DWORD Length
+ *
+ * followed by the table. A bare table cannot be mistaken for it: its second
+ * byte is the length of the first structure, which is never below 4.
+ */
+static bool isRawSMBIOSData( const uint8_t *data, size_t size, bool partial )
 {
-	BYTE    Used20CallingMethod;
-	BYTE    SMBIOSMajorVersion;
-	BYTE    SMBIOSMinorVersion;
-	BYTE    DmiRevision;
-	DWORD   Length;
-	BYTE    SMBIOSTableData[];
-};
-#endif
-
-Parser::Parser( const uint8_t *data, size_t size, int version ) : data_(data + 32), size_(size),
-    ptr_(NULL), version_(version)
+    if (size < DMI_RAW_HEADER_SIZE) return false;
+    if (data[1] != 2 && data[1] != 3) return false;
+    uint32_t length = (uint32_t) data[4] | (uint32_t) data[5] << 8 | (uint32_t) data[6] << 16 | (uint32_t) data[7] << 24;
+    // only the start of the dump may be available
+    if (!partial && length > size - DMI_RAW_HEADER_SIZE) return false;
+    if (length < DMI_ENTRY_HEADER_SIZE) return true;
+    // the first structure header must make sense
+    return size > DMI_RAW_HEADER_SIZE + 1 && data[DMI_RAW_HEADER_SIZE + 1] >= DMI_ENTRY_HEADER_SIZE;
+}
+
+static int detectFormat( const uint8_t *data, size_t size, int version, bool partial )
 {
-    int vn = 0;
+    if (isEntryPoint(data, size)) return SMBIOS_FORMAT_ENTRY_POINT;
+    if (isRawSMBIOSData(data, size, partial)) return SMBIOS_FORMAT_RAW_SMBIOS_DATA;
+    if (version != 0) return SMBIOS_FORMAT_TABLE;
+    return SMBIOS_FORMAT_AUTO;
+}
 
-    // we have a valid SMBIOS entry point?
-    #ifndef _WIN32
-    if (data[0] == '_' && data[1] == 'S' && data[2] == 'M' && data[3] == '_')
+// validates the entry point and returns the SMBIOS version (0 if invalid)
+static int parseEntryPoint( const uint8_t *data, size_t size )
+{
+    if (!isEntryPoint(data, size)) return 0;
+    if (data[3] == '_')
     {
         // version 2.x
 
         // entry point length
-        if (data[5] != 0x1F) goto INVALID_DATA;
+        if (data[5] != 0x1F) return 0;
         // entry point revision
-        if (data[10] != 0) goto INVALID_DATA;
+        if (data[10] != 0) return 0;
         // intermediate anchor string
-        if (data[16] != '_' || data[17] != 'D' || data[18] != 'M' || data[19] != 'I' || data[20] != '_') goto INVALID_DATA;
+        if (data[16] != '_' || data[17] != 'D' || data[18] != 'M' || data[19] != 'I' || data[20] != '_') return 0;
 
         // get the SMBIOS version
-        vn = data[6] << 8 | data[7];
+        return data[6] << 8 | data[7];
     }
     else
-    if (data[0] == '_' && data[1] == 'S' && data[2] == 'M' && data[3] == '3' && data[4] == '_')
     {
         // version 3.x
 
         // entry point length
-        if (data[6] != 0x18) goto INVALID_DATA;
+        if (data[6] != 0x18) return 0;
         // entry point revision
-        if (data[10] != 0x01) goto INVALID_DATA;
+        if (data[10] != 0x01) return 0;
 
         // get the SMBIOS version
-        vn = data[7] << 8 | data[8];
+        return data[7] << 8 | data[8];
     }
-    else
-        goto INVALID_DATA;
-    #else
-    RawSMBIOSData *smBiosData = NULL;
-    smBiosData = (RawSMBIOSData *) data;
-
-    // get the SMBIOS version
-    vn = smBiosData->SMBIOSMajorVersion << 8 | smBiosData->SMBIOSMinorVersion;
-    data_ = smBiosData->SMBIOSTableData;
-    size_ = smBiosData->Length;
-    #endif
-
-    if (version_ == 0) version_ = SMBIOS_3_0;
+}
+
+bool readHeader( const uint8_t *data, size_t size, int version, int format, bool partial, InputHeader &header )
+{
+    if (data == NULL) return false;
+    if (format == SMBIOS_FORMAT_AUTO) format = detectFormat(data, size, version, partial);
+
+    header.format = format;
+    header.length = SIZE_MAX;
+    switch (format)
+    {
+        case SMBIOS_FORMAT_ENTRY_POINT:
+            header.version = parseEntryPoint(data, size);
+            header.offset = DMI_ENTRY_POINT_SIZE;
+            return header.version != 0;
+        case SMBIOS_FORMAT_RAW_SMBIOS_DATA:
+            if (!isRawSMBIOSData(data, size, partial)) return false;
+            header.version = data[1] << 8 | data[2];
+            header.offset = DMI_RAW_HEADER_SIZE;
+            header.length = (size_t) data[4] | (size_t) data[5] << 8 | (size_t) data[6] << 16 | (size_t) data[7] << 24;
+            return true;
+        case SMBIOS_FORMAT_TABLE:
+            // nothing in the buffer tells the version
+            header.version = version;
+            header.offset = 0;
+            return version != 0;
+        default:
+            return false;
+    }
+}
+
+Parser::Parser( const uint8_t *data, size_t size, int version, int format ) : data_(NULL), size_(0),
+    ptr_(NULL), start_(NULL), version_(version), format_(format)
+{
+    int vn = 0;
+    InputHeader header;
+
+    if (!readHeader(data, size, version_, format_, false, header)) goto INVALID_DATA;
+    format_ = header.format;
+    vn = header.version;
+    data_ = data + header.offset;
+    size_ = (header.length == SIZE_MAX) ? size - header.offset : header.length;
+    if (vn == 0 || size_ < DMI_ENTRY_HEADER_SIZE) goto INVALID_DATA;
+
+    if (version_ == 0) version_ = SMBIOS_3_1;
     if (version_ > vn) version_ = vn;
+    // 3.2+ tables are backward compatible with the latest version we know
+    if (version_ > SMBIOS_3_1) version_ = SMBIOS_3_1;
     // is a valid version?
-    if ((version_ < SMBIOS_2_0 || version_ > SMBIOS_2_8) && version_ != SMBIOS_3_0 ) goto INVALID_DATA;
+    if ((version_ < SMBIOS_2_0 || version_ > SMBIOS_2_8) && version_ != SMBIOS_3_0 && version_ != SMBIOS_3_1) goto INVALID_DATA;
     reset();
     return;
 
 INVALID_DATA:
     data_ = ptr_ = start_ = NULL;
+    size_ = 0;
 }
 
+// Strings past the end of the buffer (or not terminated before it) read as ""
 const char *Parser::getString( int index ) const
 {
     if (index <= 0) return "";
 
     const char *ptr = (const char*) start_ + (size_t) entry_.length - DMI_ENTRY_HEADER_SIZE;
-    for (int i = 1; *ptr != 0 && i < index; ++i)
+    const char *end = (const char*) data_ + size_;
+    for (int i = 1; ptr < end && *ptr != 0; ++i)
     {
-        // TODO: check buffer limits
-        while (*ptr != 0) ++ptr;
-        ++ptr;
+        const char *nul = (const char*) memchr(ptr, 0, (size_t) (end - ptr));
+        if (nul == NULL) break;
+        if (i == index) return ptr;
+        ptr = nul + 1;
     }
-    return ptr;
+    return "";
 }
 
 void Parser::reset()
@@ -139,13 +195,19 @@ const Entry *Parser::next()
 
     memset(&entry_, 0, sizeof(entry_));
 
-    // entry header
-    entry_.type = DMI_READ_8U;
-    entry_.length = DMI_READ_8U;
-    entry_.handle = DMI_READ_16U;
+    // entry header (a malformed one ends the table, as for 'StructureIterator')
+    if (data_ + size_ - ptr_ < DMI_ENTRY_HEADER_SIZE || ptr_[1] < DMI_ENTRY_HEADER_SIZE)
+    {
+        reset();
+        return NULL;
+    }
+    entry_.type = ptr_[0];
+    entry_.length = ptr_[1];
+    entry_.handle = (uint16_t) (ptr_[2] | ptr_[3] << 8);
+    ptr_ += DMI_ENTRY_HEADER_SIZE;
     start_ = ptr_;
 
-    if (entry_.type == 127)
+    if (entry_.type == DMI_TYPE_ENDOFTABLE)
     {
         reset();
         return NULL;
@@ -154,6 +216,21 @@ const Entry *Parser::next()
     return parseEntry();
 }
 
+// Fields past the formatted area (or the buffer) read as 0: a structure shorter
+// than its version defines is followed by its strings, not by more fields
+template <typename T>
+T Parser::read()
+{
+    T value = 0;
+    size_t offset = (size_t) (ptr_ - start_);
+    size_t length = (size_t) entry_.length - DMI_ENTRY_HEADER_SIZE;
+    size_t available = (size_t) (data_ + size_ - start_);
+    if (offset + sizeof(T) <= length && offset + sizeof(T) <= available)
+        memcpy(&value, ptr_, sizeof(T));
+    ptr_ += sizeof(T);
+    return value;
+}
+
 const Entry *Parser::parseEntry()
 {
     if (entry_.type == DMI_TYPE_BIOS)
@@ -282,8 +359,8 @@ const Entry *Parser::parseEntry()
             entry_.data.sysenclosure.ContainedElements = ptr_;
             ptr_ += entry_.data.sysenclosure.ContainedElementCount * entry_.data.sysenclosure.ContainedElementRecordLength;
         }
-        // 2.7+
-        if (version_ >= SMBIOS_2_7)
+        // 2.7+ (the contained elements may have moved 'ptr_' past the structure)
+        if (version_ >= SMBIOS_2_7 && ptr_ < start_ + entry_.length - DMI_ENTRY_HEADER_SIZE)
         {
             entry_.data.sysenclosure.SKUNumber_ = DMI_READ_8U;
 
@@ -355,6 +432,36 @@ const Entry *Parser::parseEntry()
         return &entry_;
     }
     else
+    if (entry_.type == DMI_TYPE_CACHE)
+    {
+        // 2.0+
+        if (version_ >= smbios::SMBIOS_2_0)
+        {
+            entry_.data.cache.SocketDesignation_ = DMI_READ_8U;
+            entry_.data.cache.CacheConfiguration = DMI_READ_16U;
+            entry_.data.cache.MaximumCacheSize = DMI_READ_16U;
+            entry_.data.cache.InstalledSize = DMI_READ_16U;
+            entry_.data.cache.SupportedSRAMType = DMI_READ_16U;
+            entry_.data.cache.CurrentSRAMType = DMI_READ_16U;
+
+            entry_.data.cache.SocketDesignation = getString(entry_.data.cache.SocketDesignation_);
+        }
+        // 2.1+
+        if (version_ >= smbios::SMBIOS_2_1)
+        {
+            entry_.data.cache.CacheSpeed = DMI_READ_8U;
+            entry_.data.cache.ErrorCorrectionType = DMI_READ_8U;
+            entry_.data.cache.SystemCacheType = DMI_READ_8U;
+            entry_.data.cache.Associativity = DMI_READ_8U;
+        }
+        // 3.1+
+        if (version_ >= smbios::SMBIOS_3_1)
+        {
+            entry_.data.cache.MaximumCacheSize2 = DMI_READ_32U;
+            entry_.data.cache.InstalledCacheSize2 = DMI_READ_32U;
+        }
+    }
+    else
     if (entry_.type == DMI_TYPE_SYSSLOT)
     {
         // 2.0+
@@ -475,9 +582,52 @@ int Parser::version() const
     return version_;
 }
 
+int Parser::format() const
+{
+    return format_;
+}
+
 bool Parser::valid() const
 {
     return data_ != NULL;
 }
 
+const uint8_t *Parser::data() const
+{
+    return data_;
+}
+
+size_t Parser::size() const
+{
+    return size_;
+}
+
+const char *Structure::string( int index ) const
+{
+    if (index <= 0 || ptr_ == NULL) return "";
+
+    const char *ptr = (const char*) ptr_ + length();
+    const char *end = (const char*) ptr_ + size_;
+    for (int i = 1; ptr < end && *ptr != 0; ++i)
+    {
+        const char *nul = (const char*) memchr(ptr, 0, (size_t) (end - ptr));
+        if (nul == NULL) break;
+        if (i == index) return ptr;
+        ptr = nul + 1;
+    }
+    return "";
+}
+
+uint64_t cacheInstalledSize( const TypeCache &cache )
+{
+    // bit 15 (bit 31 in the 3.1+ field) selects 64 KiB granularity instead of 1 KiB
+    if (cache.InstalledSize == 0xFFFF && cache.InstalledCacheSize2 != 0)
+    {
+        uint64_t size = cache.InstalledCacheSize2 & 0x7FFFFFFF;
+        return (cache.InstalledCacheSize2 & 0x80000000) ? size * 64 : size;
+    }
+    uint64_t size = cache.InstalledSize & 0x7FFF;
+    return (cache.InstalledSize & 0x8000) ? size * 64 : size;
+}
+
 } // namespace smbios
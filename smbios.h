@@ -21,16 +21,19 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <cstring>
+#include <iterator>
 
 const int DMI_TYPE_BIOS         = 0;
 const int DMI_TYPE_SYSINFO      = 1;
 const int DMI_TYPE_BASEBOARD    = 2;
 const int DMI_TYPE_SYSENCLOSURE = 3;
 const int DMI_TYPE_PROCESSOR    = 4;
+const int DMI_TYPE_CACHE        = 7;
 const int DMI_TYPE_SYSSLOT      = 9;
 const int DMI_TYPE_OEMSTRINGS   = 11;
 const int DMI_TYPE_PHYSMEM      = 16;
 const int DMI_TYPE_MEMORY       = 17;
+const int DMI_TYPE_ENDOFTABLE   = 127;
 
 #define SMBIOS_STRING(name)  uint8_t name##_; const char * name
 
@@ -148,6 +151,26 @@ struct TypeProcessor
 	uint16_t ThreadCount2;
 };
 
+// DMI_TYPE_CACHE
+struct TypeCache
+{
+	// 2.0+
+	SMBIOS_STRING(SocketDesignation);
+	uint16_t CacheConfiguration;
+	uint16_t MaximumCacheSize;
+	uint16_t InstalledSize;
+	uint16_t SupportedSRAMType;
+	uint16_t CurrentSRAMType;
+	// 2.1+
+	uint8_t CacheSpeed;
+	uint8_t ErrorCorrectionType;
+	uint8_t SystemCacheType;
+	uint8_t Associativity;
+	// 3.1+
+	uint32_t MaximumCacheSize2;
+	uint32_t InstalledCacheSize2;
+};
+
 // DMI_TYPE_SYSSLOT
 struct SystemSlot
 {
@@ -229,6 +252,7 @@ struct Entry
     union
     {
         TypeProcessor processor;
+        TypeCache cache;
         TypeBaseboard baseboard;
         TypeSysInfo sysinfo;
         TypeBios bios;
@@ -251,17 +275,54 @@ enum SpecVersion
 	SMBIOS_2_6 = 0x0206,
 	SMBIOS_2_7 = 0x0207,
 	SMBIOS_2_8 = 0x0208,
-	SMBIOS_3_0 = 0x0300
+	SMBIOS_3_0 = 0x0300,
+	SMBIOS_3_1 = 0x0301
 };
 
+/*
+ * Layouts accepted by 'Parser'. All of them are read in place, whatever the
+ * platform the dump was taken on.
+ */
+enum InputFormat
+{
+	SMBIOS_FORMAT_AUTO = 0,         // detect one of the layouts below
+	SMBIOS_FORMAT_ENTRY_POINT,      // '_SM_' or '_SM3_' entry point (32 bytes) followed by the table (Linux 'getDMI')
+	SMBIOS_FORMAT_RAW_SMBIOS_DATA,  // 'RawSMBIOSData' header from 'GetSystemFirmwareTable' (Windows 'getDMI')
+	SMBIOS_FORMAT_TABLE             // structure table only; needs an explicit version
+};
+
+// Where the structure table of a dump starts, as told by its header
+struct InputHeader
+{
+    int format;
+    int version;    // from the header, or the version given for SMBIOS_FORMAT_TABLE
+    size_t offset;  // first byte of the table
+    size_t length;  // table length given by the header, or SIZE_MAX if the table runs to the end of the dump
+};
+
+// Bytes 'readHeader' needs to recognize any of the layouts
+const size_t DMI_HEADER_PROBE_SIZE = 32;
+
+/*
+ * Recognizes the layout of a dump ('format' may be SMBIOS_FORMAT_AUTO). With
+ * 'partial' set, 'data' may hold just the first DMI_HEADER_PROBE_SIZE bytes
+ * of the dump and the table length is not checked against 'size'.
+ */
+bool readHeader( const uint8_t *data, size_t size, int version, int format, bool partial, InputHeader &header );
+
 class Parser
 {
     public:
-        Parser( const uint8_t *data, size_t size, int version = 0 );
+        // 'version' limits the fields decoded (0 means the table version); it is required for SMBIOS_FORMAT_TABLE
+        Parser( const uint8_t *data, size_t size, int version = 0, int format = SMBIOS_FORMAT_AUTO );
         void reset();
         const Entry *next();
 		int version() const;
+		// the detected (or given) input format
+		int format() const;
 		bool valid() const;
+		const uint8_t *data() const;
+		size_t size() const;
 
     private:
         const uint8_t *data_;
@@ -270,11 +331,137 @@ class Parser
         const uint8_t *ptr_;
         const uint8_t *start_;
 		int version_;
+		int format_;
 
         const Entry *parseEntry();
         const char *getString( int index ) const;
+        template <typename T> T read();
+};
+
+/*
+ * Non-owning handle to a raw SMBIOS structure inside the table buffer: the
+ * formatted area (starting at the 4-byte header) followed by its string set.
+ * Nothing is decoded up front, so copying a handle costs two words.
+ */
+class Structure
+{
+    public:
+        Structure() : ptr_(NULL), size_(0) {}
+        Structure( const uint8_t *ptr, size_t size ) : ptr_(ptr), size_(size) {}
+
+        uint8_t type() const { return ptr_[0]; }
+        uint8_t length() const { return ptr_[1]; }
+        uint16_t handle() const { return (uint16_t) (ptr_[2] | ptr_[3] << 8); }
+        // formatted area, including the header
+        const uint8_t *data() const { return ptr_; }
+        // formatted area plus string set (including the terminating double NUL)
+        size_t size() const { return size_; }
+        // returns the string with the given 1-based index or "" if there is none
+        const char *string( int index ) const;
+
+    private:
+        const uint8_t *ptr_;
+        size_t size_;
 };
 
+/*
+ * Forward iterator over the structures of a table. It only holds the current
+ * 'Structure', so any number of them can walk the same buffer. Iteration stops
+ * at the end-of-table structure, the end of the buffer or a malformed header.
+ */
+class StructureIterator
+{
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Structure value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Structure *pointer;
+        typedef const Structure &reference;
+
+        StructureIterator() : end_(NULL) {}
+        StructureIterator( const uint8_t *ptr, const uint8_t *end ) : end_(end) { load(ptr); }
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+
+        StructureIterator &operator++()
+        {
+            load(current_.data() + current_.size());
+            return *this;
+        }
+
+        StructureIterator operator++(int)
+        {
+            StructureIterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==( const StructureIterator &that ) const { return current_.data() == that.current_.data(); }
+        bool operator!=( const StructureIterator &that ) const { return current_.data() != that.current_.data(); }
+
+    private:
+        Structure current_;
+        const uint8_t *end_;
+
+        void load( const uint8_t *ptr )
+        {
+            if (ptr == NULL || end_ - ptr < 4 || ptr[1] < 4 || end_ - ptr < ptr[1] || ptr[0] == DMI_TYPE_ENDOFTABLE)
+            {
+                current_ = Structure();
+                return;
+            }
+
+            // the string set ends with a double NUL (an empty set is just the double NUL)
+            const uint8_t *str = ptr + ptr[1];
+            while (true)
+            {
+                str = (const uint8_t*) memchr(str, 0, (size_t) (end_ - str));
+                if (str == NULL || str + 1 >= end_)
+                {
+                    // truncated string set: keep what we have, the next step stops
+                    current_ = Structure(ptr, (size_t) (end_ - ptr));
+                    return;
+                }
+                if (str[1] == 0) break;
+                str += 2;
+            }
+            current_ = Structure(ptr, (size_t) (str + 2 - ptr));
+        }
+};
+
+// Range of structures usable with range-based 'for' and standard algorithms
+class Structures
+{
+    public:
+        typedef StructureIterator iterator;
+        typedef StructureIterator const_iterator;
+
+        Structures( const uint8_t *table, size_t size ) : table_(table), size_(size) {}
+
+        iterator begin() const { return iterator(table_, table_ + size_); }
+        iterator end() const { return iterator(); }
+
+    private:
+        const uint8_t *table_;
+        size_t size_;
+};
+
+// Structures of a raw table (without entry point or firmware header)
+inline Structures structures( const uint8_t *table, size_t size )
+{
+    return Structures(table, size);
+}
+
+// Structures of the table wrapped by the parser (empty if the parser is invalid)
+inline Structures structures( const Parser &parser )
+{
+    return Structures(parser.data(), parser.valid() ? parser.size() : 0);
+}
+
+// Installed cache size in KiB, using the 3.1+ field when the 16-bit one overflows
+uint64_t cacheInstalledSize( const TypeCache &cache );
+
 } // namespace smbios
 
 #undef SMBIOS_STRING
@@ -0,0 +1,531 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "smbios_archive.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <zlib.h>
+
+#define TAR_BLOCK_SIZE  512
+#define DMI_EP_SIZE     32
+
+namespace smbios {
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed( Clock::time_point start )
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+IngestOptions::IngestOptions() : decompressThreads(1), parseThreads(std::thread::hardware_concurrency()),
+    queueDepth(64)
+{
+    if (parseThreads == 0) parseThreads = 1;
+}
+
+namespace {
+
+struct Table
+{
+    std::string name;
+    std::vector<uint8_t> data;
+};
+
+class TableQueue
+{
+    public:
+        TableQueue( size_t capacity ) : capacity_(capacity), producers_(0), closed_(false) {}
+
+        void addProducer()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++producers_;
+        }
+
+        void removeProducer()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--producers_ == 0) notEmpty_.notify_all();
+        }
+
+        // wakes every thread and makes 'push' and 'pop' fail from now on
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            notFull_.notify_all();
+            notEmpty_.notify_all();
+        }
+
+        bool closed()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return closed_;
+        }
+
+        // blocks while the queue is full; returns false if it was closed
+        bool push( Table &table, double &blocked )
+        {
+            Clock::time_point start = Clock::now();
+            std::unique_lock<std::mutex> lock(mutex_);
+            notFull_.wait(lock, [this]{ return items_.size() < capacity_ || closed_; });
+            blocked += elapsed(start);
+            if (closed_) return false;
+            items_.push_back(Table());
+            items_.back().name.swap(table.name);
+            items_.back().data.swap(table.data);
+            notEmpty_.notify_one();
+            return true;
+        }
+
+        // blocks while the queue is empty; returns false once it is drained and every producer is done, or closed
+        bool pop( Table &table, double &blocked )
+        {
+            Clock::time_point start = Clock::now();
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [this]{ return !items_.empty() || producers_ == 0 || closed_; });
+            blocked += elapsed(start);
+            if (items_.empty() || closed_) return false;
+            table.name.swap(items_.front().name);
+            table.data.swap(items_.front().data);
+            items_.pop_front();
+            notFull_.notify_one();
+            return true;
+        }
+
+    private:
+        std::deque<Table> items_;
+        size_t capacity_;
+        int producers_;
+        bool closed_;
+        std::mutex mutex_;
+        std::condition_variable notFull_;
+        std::condition_variable notEmpty_;
+};
+
+struct TarMember
+{
+    std::string name;
+    char type;
+    uint64_t size;
+};
+
+bool readFully( gzFile file, void *buffer, size_t size )
+{
+    uint8_t *ptr = (uint8_t*) buffer;
+    while (size > 0)
+    {
+        unsigned chunk = (size > (1U << 30)) ? (1U << 30) : (unsigned) size;
+        int count = gzread(file, ptr, chunk);
+        if (count <= 0) return false;
+        ptr += count;
+        size -= (size_t) count;
+    }
+    return true;
+}
+
+bool skip( gzFile file, uint64_t size )
+{
+    uint8_t buffer[4096];
+    while (size > 0)
+    {
+        size_t chunk = (size > sizeof(buffer)) ? sizeof(buffer) : (size_t) size;
+        if (!readFully(file, buffer, chunk)) return false;
+        size -= chunk;
+    }
+    return true;
+}
+
+/*
+ * Reads a numeric header field: octal digits, or the GNU base-256 form (first
+ * byte with the high bit set, then a big-endian number) used for sizes that do
+ * not fit 11 octal digits. Returns false for negative or overflowing values.
+ */
+bool parseNumber( const char *field, size_t length, uint64_t &value )
+{
+    value = 0;
+    const uint8_t *ptr = (const uint8_t*) field;
+    if (ptr[0] & 0x80)
+    {
+        // bit 6 is the sign
+        if (ptr[0] & 0x40) return false;
+        value = ptr[0] & 0x3F;
+        for (size_t i = 1; i < length; ++i)
+        {
+            if (value > (UINT64_MAX >> 8)) return false;
+            value = value << 8 | ptr[i];
+        }
+        return true;
+    }
+
+    for (size_t i = 0; i < length && field[i] != 0; ++i)
+    {
+        if (field[i] == ' ') continue;
+        if (field[i] < '0' || field[i] > '7') break;
+        if (value > (UINT64_MAX >> 3)) return false;
+        value = value * 8 + (uint64_t) (field[i] - '0');
+    }
+    return true;
+}
+
+std::string fieldString( const char *field, size_t length )
+{
+    size_t size = 0;
+    while (size < length && field[size] != 0) ++size;
+    return std::string(field, size);
+}
+
+// extracts the 'path' record from a pax extended header
+std::string paxPath( const std::vector<uint8_t> &data )
+{
+    size_t pos = 0;
+    while (pos < data.size())
+    {
+        // records are "<length> <key>=<value>\n"
+        size_t length = 0, i = pos;
+        while (i < data.size() && data[i] >= '0' && data[i] <= '9') length = length * 10 + (data[i++] - '0');
+        if (length == 0 || pos + length > data.size()) break;
+        const char *record = (const char*) data.data() + i + 1;
+        size_t recordSize = pos + length - (i + 1);
+        if (recordSize > 6 && memcmp(record, "path=", 5) == 0)
+            return std::string(record + 5, recordSize - 6);
+        pos += length;
+    }
+    return std::string();
+}
+
+// reads the next regular member header, consuming long-name and pax headers;
+// 'failed' tells a broken archive from its end
+bool nextMember( gzFile file, TarMember &member, bool &failed )
+{
+    char header[TAR_BLOCK_SIZE];
+    std::string longName;
+
+    while (true)
+    {
+        failed = false;
+        if (!readFully(file, header, sizeof(header))) return false;
+        // two zero blocks mark the end of the archive; one is enough for us
+        if (header[0] == 0) return false;
+
+        // from here on, stopping leaves the archive unread
+        failed = true;
+        member.type = header[156];
+        // without the size the next header cannot be found
+        if (!parseNumber(header + 124, 12, member.size)) return false;
+        uint64_t padded = (member.size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+
+        if (member.type == 'L' || member.type == 'x')
+        {
+            // a name that long is bogus; the member keeps its short name
+            if (member.size > DMI_MAX_MEMBER_SIZE)
+            {
+                if (!skip(file, padded)) return false;
+                continue;
+            }
+            std::vector<uint8_t> data((size_t) padded);
+            if (!readFully(file, data.data(), data.size())) return false;
+            data.resize((size_t) member.size);
+            if (member.type == 'L')
+                longName = fieldString((const char*) data.data(), data.size());
+            else
+                longName = paxPath(data);
+            continue;
+        }
+
+        if (!longName.empty())
+            member.name.swap(longName);
+        else
+        {
+            member.name = fieldString(header, 100);
+            // ustar keeps the leading part of long paths in 'prefix'
+            if (memcmp(header + 257, "ustar", 5) == 0 && header[345] != 0)
+                member.name = fieldString(header + 345, 155) + "/" + member.name;
+        }
+
+        if (member.type == '0' || member.type == 0)
+        {
+            failed = false;
+            return true;
+        }
+        if (!skip(file, padded)) return false;
+    }
+}
+
+void splitPath( const std::string &path, std::string &dir, std::string &base )
+{
+    size_t pos = path.rfind('/');
+    if (pos == std::string::npos)
+    {
+        dir.clear();
+        base = path;
+    }
+    else
+    {
+        dir = path.substr(0, pos);
+        base = path.substr(pos + 1);
+    }
+}
+
+struct Context
+{
+    const std::vector<std::string> *archives;
+    const TableHandler *handler;
+    TableQueue *queue;
+    std::atomic<size_t> nextArchive;
+    std::mutex statsMutex;
+    IngestStats *stats;
+};
+
+// closes the archive however 'readArchive' is left
+struct ArchiveFile
+{
+    gzFile file;
+
+    ArchiveFile( gzFile file ) : file(file) {}
+    ~ArchiveFile() { if (file != NULL) gzclose(file); }
+};
+
+// queues the tables of one archive; false if it could not be read to the end
+bool readArchive( Context *context, const std::string &path, StageStats &local, uint64_t &invalid )
+{
+    ArchiveFile archive(gzopen(path.c_str(), "rb"));
+    gzFile file = archive.file;
+    if (file == NULL) return false;
+    gzbuffer(file, 128 * 1024);
+
+    // sysfs dumps come as two sibling members; keep the first until the other shows up
+    Table pending;
+    std::string pendingDir, pendingBase;
+    TarMember member;
+    std::string dir, base;
+
+    bool failed = false;
+    while (nextMember(file, member, failed))
+    {
+        uint64_t padded = (member.size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+        // the header size is not trusted with an allocation
+        if (member.size > DMI_MAX_MEMBER_SIZE)
+        {
+            if (!skip(file, padded)) return false;
+            ++invalid;
+            continue;
+        }
+        Table table;
+        table.data.resize((size_t) padded);
+        if (!readFully(file, table.data.data(), table.data.size())) return false;
+        table.data.resize((size_t) member.size);
+        if (member.size == 0) continue;
+
+        splitPath(member.name, dir, base);
+        if (base == "DMI" || base == "smbios_entry_point")
+        {
+            if (pendingBase.empty() || pendingDir != dir || pendingBase == base)
+            {
+                // the member waiting for its partner never got one
+                if (!pendingBase.empty()) ++invalid;
+                pending.data.swap(table.data);
+                pendingDir = dir;
+                pendingBase = base;
+                continue;
+            }
+            std::vector<uint8_t> &entryPoint = (base == "DMI") ? pending.data : table.data;
+            std::vector<uint8_t> &structures = (base == "DMI") ? table.data : pending.data;
+            std::vector<uint8_t> joined(DMI_EP_SIZE + structures.size(), 0);
+            memcpy(joined.data(), entryPoint.data(), (entryPoint.size() < DMI_EP_SIZE) ? entryPoint.size() : DMI_EP_SIZE);
+            memcpy(joined.data() + DMI_EP_SIZE, structures.data(), structures.size());
+            table.data.swap(joined);
+            table.name = path + ":" + dir;
+            pendingBase.clear();
+        }
+        else
+            table.name = path + ":" + member.name;
+
+        local.items++;
+        local.bytes += table.data.size();
+        if (!context->queue->push(table, local.blocked)) return false;
+    }
+    if (!pendingBase.empty()) ++invalid;
+    return !failed;
+}
+
+void decompressWorker( Context *context )
+{
+    StageStats local = StageStats();
+    uint64_t failed = 0;
+    uint64_t invalid = 0;
+    Clock::time_point start = Clock::now();
+
+    while (!context->queue->closed())
+    {
+        size_t index = context->nextArchive.fetch_add(1);
+        if (index >= context->archives->size()) break;
+
+        // an exception escaping a thread would terminate the process
+        bool ok = false;
+        try
+        {
+            ok = readArchive(context, (*context->archives)[index], local, invalid);
+        }
+        catch (...)
+        {
+        }
+        if (!ok) ++failed;
+    }
+
+    local.busy = elapsed(start) - local.blocked;
+    context->queue->removeProducer();
+
+    std::lock_guard<std::mutex> lock(context->statsMutex);
+    StageStats &stats = context->stats->decompress;
+    stats.items += local.items;
+    stats.bytes += local.bytes;
+    stats.busy += local.busy;
+    stats.blocked += local.blocked;
+    context->stats->failedArchives += failed;
+    context->stats->invalidTables += invalid;
+}
+
+void parseWorker( Context *context )
+{
+    StageStats local = StageStats();
+    uint64_t invalid = 0;
+    uint64_t errors = 0;
+    Clock::time_point start = Clock::now();
+    double blocked = 0;
+    Table table;
+
+    while (context->queue->pop(table, blocked))
+    {
+        Parser parser(table.data.data(), table.data.size());
+        if (!parser.valid())
+        {
+            ++invalid;
+            continue;
+        }
+        try
+        {
+            (*context->handler)(table.name, parser);
+        }
+        catch (...)
+        {
+            ++errors;
+        }
+        local.items++;
+        local.bytes += table.data.size();
+    }
+
+    local.blocked = blocked;
+    local.busy = elapsed(start) - blocked;
+
+    std::lock_guard<std::mutex> lock(context->statsMutex);
+    StageStats &stats = context->stats->parse;
+    stats.items += local.items;
+    stats.bytes += local.bytes;
+    stats.busy += local.busy;
+    stats.blocked += local.blocked;
+    context->stats->invalidTables += invalid;
+    context->stats->handlerErrors += errors;
+}
+
+}
+
+bool ingestArchives(
+    const std::vector<std::string> &archives,
+    const TableHandler &handler,
+    IngestStats &stats,
+    const IngestOptions &options )
+{
+    memset(&stats, 0, sizeof(stats));
+    stats.archives = archives.size();
+    if (options.decompressThreads == 0 || options.parseThreads == 0 || options.queueDepth == 0) return false;
+
+    Clock::time_point start = Clock::now();
+    TableQueue queue(options.queueDepth);
+    Context context;
+    context.archives = &archives;
+    context.handler = &handler;
+    context.queue = &queue;
+    context.nextArchive = 0;
+    context.stats = &stats;
+
+    stats.decompress.threads = (uint32_t) options.decompressThreads;
+    stats.parse.threads = (uint32_t) options.parseThreads;
+    std::vector<std::thread> threads;
+    bool started = true;
+    try
+    {
+        // with the room reserved, only the thread constructor can throw
+        threads.reserve(options.decompressThreads + options.parseThreads);
+        for (size_t i = 0; i < options.decompressThreads; ++i)
+        {
+            queue.addProducer();
+            threads.push_back(std::thread(decompressWorker, &context));
+        }
+        for (size_t i = 0; i < options.parseThreads; ++i)
+            threads.push_back(std::thread(parseWorker, &context));
+    }
+    catch (...)
+    {
+        // the threads already running would wait on the queue forever
+        queue.close();
+        started = false;
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+
+    stats.wall = elapsed(start);
+    return started && stats.failedArchives == 0;
+}
+
+static void printStage( const char *name, const StageStats &stage, double wall, std::ostream &output )
+{
+    output << "[ingest] " << name << "_threads:" << stage.threads << '\n';
+    output << "[ingest] " << name << "_tables:" << stage.items << '\n';
+    output << "[ingest] " << name << "_bytes:" << stage.bytes << '\n';
+    output << "[ingest] " << name << "_busy:" << stage.busy << " s\n";
+    output << "[ingest] " << name << "_blocked:" << stage.blocked << " s\n";
+    if (wall > 0)
+    {
+        output << "[ingest] " << name << "_tables_per_sec:" << (double) stage.items / wall << '\n';
+        output << "[ingest] " << name << "_mib_per_sec:" << (double) stage.bytes / wall / (1024 * 1024) << '\n';
+    }
+}
+
+void printIngestStats( const IngestStats &stats, std::ostream &output )
+{
+    output << "[ingest] archives:" << stats.archives << '\n';
+    output << "[ingest] failed_archives:" << stats.failedArchives << '\n';
+    output << "[ingest] invalid_tables:" << stats.invalidTables << '\n';
+    output << "[ingest] handler_errors:" << stats.handlerErrors << '\n';
+    output << "[ingest] wall:" << stats.wall << " s\n";
+    printStage("decompress", stats.decompress, stats.wall, output);
+    printStage("parse", stats.parse, stats.wall, output);
+    // the stage whose threads spend the least time waiting on the queue is the bottleneck
+    double decompressWait = (stats.decompress.threads > 0) ? stats.decompress.blocked / stats.decompress.threads : 0;
+    double parseWait = (stats.parse.threads > 0) ? stats.parse.blocked / stats.parse.threads : 0;
+    output << "[ingest] bottleneck:" << ((decompressWait > parseWait) ? "parse" : "decompress") << '\n';
+}
+
+} // namespace smbios
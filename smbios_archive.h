@@ -0,0 +1,91 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SMBIOS_ARCHIVE_HH
+#define SMBIOS_ARCHIVE_HH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "smbios.h"
+
+/*
+ * Ingestion of DMI dumps archived as gzip-compressed tarballs.
+ *
+ * Decompression threads stream archive members into memory and push each
+ * complete table into a bounded queue; parser threads pop the tables and hand
+ * a 'smbios::Parser' to the caller. A full queue blocks the decompression side
+ * (back-pressure), so memory use is bounded by the queue depth.
+ *
+ * A member named 'DMI' next to a 'smbios_entry_point' member in the same
+ * directory (the layout of /sys/firmware/dmi/tables) is joined into the buffer
+ * layout produced by 'getDMI'. Any other regular member is taken as a complete
+ * dump already in that layout.
+ */
+
+namespace smbios {
+
+// Larger members are skipped and counted as invalid tables (no real dump comes close)
+const uint64_t DMI_MAX_MEMBER_SIZE = 16 * 1024 * 1024;
+
+struct StageStats
+{
+    uint32_t threads;
+    uint64_t items;
+    uint64_t bytes;
+    double busy;     // seconds spent working, summed over the threads of the stage
+    double blocked;  // seconds spent waiting on the queue (full for producers, empty for consumers)
+};
+
+struct IngestStats
+{
+    StageStats decompress;
+    StageStats parse;
+    uint64_t archives;
+    uint64_t failedArchives;   // unreadable, truncated or aborted by an exception
+    uint64_t invalidTables;    // not SMBIOS, over DMI_MAX_MEMBER_SIZE or a DMI/entry point member without its partner
+    uint64_t handlerErrors;    // tables whose handler threw
+    double wall;
+};
+
+struct IngestOptions
+{
+    size_t decompressThreads;
+    size_t parseThreads;
+    size_t queueDepth;
+
+    IngestOptions();
+};
+
+// Called from the parser threads (concurrently) for every valid table; exceptions are counted, not propagated
+typedef std::function<void( const std::string &name, Parser &parser )> TableHandler;
+
+// Returns false if an archive could not be read to the end or the threads could not be started
+bool ingestArchives(
+    const std::vector<std::string> &archives,
+    const TableHandler &handler,
+    IngestStats &stats,
+    const IngestOptions &options = IngestOptions() );
+
+void printIngestStats( const IngestStats &stats, std::ostream &output );
+
+} // namespace smbios
+
+#endif // SMBIOS_ARCHIVE_HH
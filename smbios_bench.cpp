@@ -0,0 +1,1282 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "smbios_bench.h"
+#include "smbios.h"
+#include "smbios_bulk.h"
+#include "smbios_core.h"
+#include "smbios_index.h"
+#include "smbios_stream.h"
+#include "smbios_strings.h"
+#include "smbios_topology.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include "smbios_decode.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+extern char **environ;
+
+// size of the entry point area in the 'getDMI' layout
+#define DMI_EP_SIZE  32
+#define DMI_ENTRY_HEADER_SIZE  4
+
+namespace smbios {
+
+static uint64_t nowNanoseconds()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+PerfCounters::PerfCounters( bool open ) : leader_(-1), start_(0)
+{
+    for (int i = 0; i < PERF_COUNTERS; ++i) fds_[i] = -1;
+    if (!open)
+    {
+        error_ = "disabled";
+        return;
+    }
+
+    #ifdef __linux__
+    static const struct
+    {
+        uint32_t type;
+        uint64_t config;
+    } EVENTS[PERF_COUNTERS] =
+    {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    };
+
+    int error = 0;
+    for (int i = 0; i < PERF_COUNTERS; ++i)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = EVENTS[i].type;
+        attr.config = EVENTS[i].config;
+        // the whole group is enabled and disabled through the leader
+        attr.disabled = (leader_ < 0) ? 1 : 0;
+        // user space only, which is allowed with the default perf_event_paranoid
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // a counter the PMU lacks (or that does not fit the group) is just left out
+        fds_[i] = (int) syscall(__NR_perf_event_open, &attr, 0, -1, leader_, PERF_FLAG_FD_CLOEXEC);
+        if (fds_[i] < 0)
+        {
+            if (error == 0) error = errno;
+            continue;
+        }
+        if (leader_ < 0) leader_ = fds_[i];
+    }
+    if (leader_ < 0)
+        error_ = std::string("perf_event_open: ") + strerror(error);
+    #else
+    error_ = "perf_event_open is only available on Linux";
+    #endif
+}
+
+PerfCounters::~PerfCounters()
+{
+    #ifdef __linux__
+    for (int i = 0; i < PERF_COUNTERS; ++i)
+        if (fds_[i] >= 0) close(fds_[i]);
+    #endif
+}
+
+bool PerfCounters::available() const
+{
+    return leader_ >= 0;
+}
+
+bool PerfCounters::available( int counter ) const
+{
+    return counter >= 0 && counter < PERF_COUNTERS && fds_[counter] >= 0;
+}
+
+const std::string &PerfCounters::error() const
+{
+    return error_;
+}
+
+void PerfCounters::start()
+{
+    #ifdef __linux__
+    if (leader_ >= 0)
+    {
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    #endif
+    start_ = nowNanoseconds();
+}
+
+void PerfCounters::stop( CounterValues &values )
+{
+    uint64_t end = nowNanoseconds();
+    #ifdef __linux__
+    if (leader_ >= 0) ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    #endif
+
+    values.wall = (double) (end - start_) / 1e9;
+    for (int i = 0; i < PERF_COUNTERS; ++i)
+    {
+        values.values[i] = 0;
+        values.valid[i] = false;
+        #ifdef __linux__
+        // value, time enabled, time running
+        uint64_t data[3];
+        if (fds_[i] < 0 || read(fds_[i], data, sizeof(data)) != (ssize_t) sizeof(data) || data[2] == 0) continue;
+        values.values[i] = (data[2] < data[1]) ? (uint64_t) ((double) data[0] * (double) data[1] / (double) data[2]) : data[0];
+        values.valid[i] = true;
+        #endif
+    }
+}
+
+const char *perfCounterName( int counter )
+{
+    static const char *NAMES[PERF_COUNTERS] = { "cycles", "instructions", "branch-misses", "L1D-misses", "LLC-misses" };
+    return (counter >= 0 && counter < PERF_COUNTERS) ? NAMES[counter] : "";
+}
+
+const char *benchStageName( int stage )
+{
+    static const char *NAMES[BENCH_STAGES] = { "next", "iterate", "strings", "sanitize", "topology", "emit",
+        "print", "index", "bulk" };
+    return (stage >= 0 && stage < BENCH_STAGES) ? NAMES[stage] : "";
+}
+
+int benchStage( const char *name )
+{
+    int stage = 0;
+    while (stage < BENCH_STAGES && strcmp(benchStageName(stage), name) != 0) ++stage;
+    return stage;
+}
+
+BenchOptions::BenchOptions() : iterations(1000), counters(true), stages((1U << BENCH_STAGES) - 1),
+    tempDirectory("/tmp")
+{
+}
+
+namespace {
+
+// Appends structures to a table; strings are collected and written by 'end'
+class TableWriter
+{
+    public:
+        TableWriter( std::vector<uint8_t> &buffer, bool dirty ) : buffer_(buffer), start_(0), handle_(0), count_(0),
+            dirty_(dirty), serial_(0) {}
+
+        uint16_t begin( uint8_t type )
+        {
+            start_ = buffer_.size();
+            strings_.clear();
+            count_ = 0;
+            byte(type);
+            byte(0);
+            word(handle_);
+            return handle_++;
+        }
+
+        void byte( uint8_t value ) { buffer_.push_back(value); }
+        void word( uint16_t value ) { byte((uint8_t) value); byte((uint8_t) (value >> 8)); }
+        void dword( uint32_t value ) { word((uint16_t) value); word((uint16_t) (value >> 16)); }
+        void qword( uint64_t value ) { dword((uint32_t) value); dword((uint32_t) (value >> 32)); }
+
+        // adds a string to the string set and returns its index
+        uint8_t add( const std::string &value )
+        {
+            strings_ += dirty_ ? dirty(value) : value;
+            strings_ += '\0';
+            return ++count_;
+        }
+
+        // adds a string and writes its index in the formatted area
+        void string( const std::string &value ) { byte(add(value)); }
+
+        void end()
+        {
+            buffer_[start_ + 1] = (uint8_t) (buffer_.size() - start_);
+            if (strings_.empty())
+                byte(0);
+            else
+                buffer_.insert(buffer_.end(), strings_.begin(), strings_.end());
+            byte(0);
+        }
+
+    private:
+        std::vector<uint8_t> &buffer_;
+        size_t start_;
+        uint16_t handle_;
+        std::string strings_;
+        uint8_t count_;
+        bool dirty_;
+        uint32_t serial_;
+
+        // the kinds of damage found in real tables, mixed so that every string has some
+        std::string dirty( const std::string &value )
+        {
+            uint32_t serial = serial_++;
+            std::string result;
+            if (serial % 2 == 0) result += ' ';
+            result += value;
+            size_t middle = 1 + result.size() / 2;
+            if (serial % 3 == 0) result.insert(middle, 1, '\x01');
+            if (serial % 5 == 0) result.insert(middle, "\xC3\xA9");
+            result.append(serial % 4 * 4, ' ');
+            if (serial % 7 == 0 || result == value) result.append(4, '\xFF');
+            return result;
+        }
+};
+
+// Counts the bytes 'emitSMBIOS' produces without keeping them
+void countBytes( void *context, const char *data, size_t size )
+{
+    (void) data;
+    *(uint64_t*) context += size;
+}
+
+class NullBuffer : public std::streambuf
+{
+    protected:
+        int overflow( int c ) { return c; }
+        std::streamsize xsputn( const char *data, std::streamsize size ) { (void) data; return size; }
+};
+
+// Keeps the compiler from dropping the measured loops
+volatile uint64_t sink;
+
+// What the stages of one table work on
+struct StageContext
+{
+    const std::string *name;
+    Parser *parser;
+    IndexBuilder *index;
+    BulkReader *bulk;
+    std::vector<std::string> files;  // the table written to a file, for BENCH_BULK
+};
+
+void runStage( int stage, StageContext &context )
+{
+    Parser &parser = *context.parser;
+    uint64_t total = 0;
+    if (stage == BENCH_NEXT)
+    {
+        parser.reset();
+        for (const Entry *entry = parser.next(); entry != NULL; entry = parser.next())
+            total += entry->type;
+    }
+    else
+    if (stage == BENCH_ITERATE)
+    {
+        // same decoding as 'next', one structure at a time (as 'StreamParser' does)
+        for (const Structure &structure : structures(parser))
+        {
+            Parser decoder(structure.data(), structure.size(), parser.version(), SMBIOS_FORMAT_TABLE);
+            const Entry *entry = decoder.next();
+            if (entry != NULL) total += entry->type;
+        }
+    }
+    else
+    if (stage == BENCH_STRINGS || stage == BENCH_SANITIZE)
+    {
+        Structures range = structures(parser);
+        for (StructureIterator it = range.begin(); it != range.end(); ++it)
+        {
+            const Structure &entry = *it;
+            for (int i = 1; ; ++i)
+            {
+                const char *str = entry.string(i);
+                if (*str == 0) break;
+                if (stage == BENCH_STRINGS)
+                    total += (uint8_t) *str;
+                else
+                {
+                    SanitizedString value = sanitizeString(str);
+                    total += value.length + (uint64_t) value.flags;
+                }
+            }
+        }
+    }
+    else
+    if (stage == BENCH_TOPOLOGY)
+    {
+        Topology topology;
+        if (getTopology(parser, topology)) total += topology.threads;
+    }
+    else
+    if (stage == BENCH_EMIT)
+    {
+        ByteSink counter = { countBytes, &total };
+        parser.reset();
+        emitSMBIOS(parser, counter);
+    }
+    else
+    if (stage == BENCH_PRINT)
+    {
+        NullBuffer buffer;
+        std::ostream output(&buffer);
+        parser.reset();
+        printSMBIOS(parser, output);
+    }
+    else
+    if (stage == BENCH_INDEX)
+    {
+        total += context.index->addTable(*context.name, parser);
+    }
+    else
+    if (stage == BENCH_BULK)
+    {
+        BulkStats stats;
+        context.bulk->read(context.files, [&total]( const std::string &path, Parser &loaded )
+            {
+                (void) path;
+                for (const Entry *entry = loaded.next(); entry != NULL; entry = loaded.next())
+                    total += entry->type;
+            }, stats);
+    }
+    sink = sink + total;
+}
+
+bool writeAll( int fd, const uint8_t *data, size_t size )
+{
+    size_t total = 0;
+    while (total < size)
+    {
+        ssize_t count = write(fd, data + total, size - total);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        total += (size_t) count;
+    }
+    return true;
+}
+
+// Writes the table to a new file in 'directory' and returns its path (empty on error)
+std::string writeTempFile( const std::string &directory, const std::vector<uint8_t> &data )
+{
+    std::string path = directory + "/smbios-bench-XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) return std::string();
+
+    bool ok = writeAll(fd, data.data(), data.size());
+    close(fd);
+    if (ok) return path;
+    unlink(path.c_str());
+    return std::string();
+}
+
+bool writeFile( const std::string &path, const uint8_t *data, size_t size )
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return false;
+    bool ok = writeAll(fd, data, size);
+    return close(fd) == 0 && ok;
+}
+
+// Appends a regular ustar member to a gzip stream
+bool writeTarMember( gzFile file, const std::string &name, const uint8_t *data, size_t size )
+{
+    char header[512];
+    memset(header, 0, sizeof(header));
+    if (name.size() >= 100) return false;
+    memcpy(header, name.data(), name.size());
+    snprintf(header + 100, 8, "%07o", 0600);
+    snprintf(header + 108, 8, "%07o", 0);
+    snprintf(header + 116, 8, "%07o", 0);
+    snprintf(header + 124, 12, "%011llo", (unsigned long long) size);
+    snprintf(header + 136, 12, "%011o", 0);
+    header[156] = '0';
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+    // the checksum is computed with its own field as spaces
+    memset(header + 148, ' ', 8);
+    unsigned checksum = 0;
+    for (size_t i = 0; i < sizeof(header); ++i) checksum += (uint8_t) header[i];
+    snprintf(header + 148, 7, "%06o", checksum);
+
+    static const uint8_t PADDING[512] = { 0 };
+    size_t padding = (512 - size % 512) % 512;
+    return gzwrite(file, header, sizeof(header)) == (int) sizeof(header) &&
+        (size == 0 || gzwrite(file, data, (unsigned) size) == (int) size) &&
+        (padding == 0 || gzwrite(file, PADDING, (unsigned) padding) == (int) padding);
+}
+
+// Fields of the entry that tell a wrong offset or string apart, with the raw structure
+// strings the version does not define are left NULL
+const char *text( const char *value )
+{
+    return (value != NULL) ? value : "";
+}
+
+std::string describeEntry( const Entry &entry, const Structure &structure )
+{
+    std::ostringstream out;
+    out << (int) entry.type << '/' << entry.handle << '/' << (int) entry.length << '/' << structure.size() << ':';
+    out.write((const char*) structure.data(), (std::streamsize) structure.size());
+    out << ':';
+    switch (entry.type)
+    {
+        case DMI_TYPE_BIOS:
+            out << text(entry.data.bios.Vendor) << '|' << text(entry.data.bios.BIOSVersion) << '|'
+                << text(entry.data.bios.BIOSReleaseDate) << '|' << (int) entry.data.bios.ExtensionByte2 << '|'
+                << (int) entry.data.bios.SystemBIOSMajorRelease;
+            break;
+        case DMI_TYPE_SYSINFO:
+            out << text(entry.data.sysinfo.Manufacturer) << '|' << text(entry.data.sysinfo.SerialNumber) << '|'
+                << text(entry.data.sysinfo.Family) << '|' << (int) entry.data.sysinfo.UUID[15];
+            break;
+        case DMI_TYPE_PROCESSOR:
+            out << text(entry.data.processor.SocketDesignation) << '|' << text(entry.data.processor.ProcessorVersion) << '|'
+                << text(entry.data.processor.PartNumber) << '|' << entry.data.processor.L3CacheHandle << '|'
+                << entry.data.processor.ThreadCount2;
+            break;
+        case DMI_TYPE_CACHE:
+            out << text(entry.data.cache.SocketDesignation) << '|' << entry.data.cache.InstalledCacheSize2;
+            break;
+        case DMI_TYPE_MEMORY:
+            out << text(entry.data.memory.DeviceLocator) << '|' << text(entry.data.memory.SerialNumber) << '|'
+                << text(entry.data.memory.PartNumber) << '|' << entry.data.memory.ConfiguredClockSpeed;
+            break;
+    }
+    return out.str();
+}
+
+std::vector<std::string> describeTable( const std::vector<uint8_t> &data )
+{
+    std::vector<std::string> result;
+    Parser parser(data.data(), data.size());
+    Structures range = structures(parser);
+    StructureIterator it = range.begin();
+    for (const Entry *entry = parser.next(); entry != NULL && it != range.end(); entry = parser.next(), ++it)
+        result.push_back(describeEntry(*entry, *it));
+    if (!parser.valid()) result.push_back("invalid");
+    return result;
+}
+
+// Feeds the table in chunks of 'chunk' bytes (random sizes of 1 to 97 bytes if 0)
+std::vector<std::string> describeStream( const std::vector<uint8_t> &data, size_t chunk, std::mt19937 &random )
+{
+    std::vector<std::string> result;
+    StreamParser stream([&result]( const Entry &entry, const Structure &structure )
+        {
+            result.push_back(describeEntry(entry, structure));
+        });
+    std::vector<uint8_t> piece;
+    for (size_t offset = 0; offset < data.size(); )
+    {
+        size_t size = (chunk > 0) ? chunk : 1 + random() % 97;
+        if (size > data.size() - offset) size = data.size() - offset;
+        // a copy of its own, so reading past the chunk is caught by the sanitizers
+        piece.assign(data.begin() + (ptrdiff_t) offset, data.begin() + (ptrdiff_t) (offset + size));
+        stream.push(piece.data(), piece.size());
+        offset += size;
+    }
+    if (!stream.finish()) result.push_back("invalid");
+    return result;
+}
+
+/*
+ * Copy of the table whose structures lose the last 'cut' bytes of their
+ * formatted area (keeping the header), as firmware older than the version it
+ * reports writes them: the fields past the length must read as 0.
+ */
+std::vector<uint8_t> shortenStructures( const std::vector<uint8_t> &data, size_t cut )
+{
+    Parser parser(data.data(), data.size());
+    std::vector<uint8_t> result(data.data(), parser.data());
+    Structures range = structures(parser);
+    const uint8_t *last = parser.data();
+    for (StructureIterator it = range.begin(); it != range.end(); ++it)
+    {
+        size_t length = it->length();
+        size_t kept = (length > DMI_ENTRY_HEADER_SIZE + cut) ? length - cut : DMI_ENTRY_HEADER_SIZE;
+        result.insert(result.end(), it->data(), it->data() + kept);
+        result[result.size() - kept + 1] = (uint8_t) kept;
+        result.insert(result.end(), it->data() + length, it->data() + it->size());
+        last = it->data() + it->size();
+    }
+    // the end-of-table structure and anything after it
+    result.insert(result.end(), last, data.data() + data.size());
+    if (parser.format() == SMBIOS_FORMAT_RAW_SMBIOS_DATA)
+    {
+        // the header gives the table length
+        size_t length = result.size() - (size_t) (parser.data() - data.data());
+        for (int i = 0; i < 4; ++i) result[4 + i] = (uint8_t) (length >> (i * 8));
+    }
+    return result;
+}
+
+// Walks the structures of a loaded dump, the same work whatever loaded it
+uint64_t walkDump( const Parser &parser )
+{
+    uint64_t total = 0;
+    Structures range = structures(parser);
+    for (StructureIterator it = range.begin(); it != range.end(); ++it) total += it->type();
+    return total;
+}
+
+}
+
+std::string serviceTag( uint32_t serial )
+{
+    if (serial == 0) return "4XK5Q73";
+    static const char DIGITS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::string tag(7, '0');
+    for (int i = 6; i >= 0 && serial != 0; --i, serial /= 36) tag[(size_t) i] = DIGITS[serial % 36];
+    return tag;
+}
+
+void makeSyntheticTable( int sockets, int dimms, std::vector<uint8_t> &buffer, bool dirty, uint32_t serial )
+{
+    buffer.assign(32, 0);
+    TableWriter table(buffer, dirty);
+
+    table.begin(DMI_TYPE_BIOS);
+    table.string("American Megatrends Inc.");
+    table.string("2.14.1");
+    table.word(0xF000);
+    table.string("03/25/2021");
+    table.byte(0xFF);
+    table.qword(0x000000017FFFF880ULL);
+    table.byte(0x03);
+    table.byte(0x0D);
+    table.byte(2);
+    table.byte(14);
+    table.byte(0xFF);
+    table.byte(0xFF);
+    table.word(0x0020);
+    table.end();
+
+    table.begin(DMI_TYPE_SYSINFO);
+    table.string("Dell Inc.");
+    table.string("PowerEdge R740");
+    table.string("Not Specified");
+    table.string(serviceTag(serial));
+    for (int i = 0; i < 16; ++i) table.byte((uint8_t) (0x4C + i * 7));
+    table.byte(0x06);
+    table.string("SKU=NotProvided;ModelName=PowerEdge R740");
+    table.string("PowerEdge");
+    table.end();
+
+    table.begin(DMI_TYPE_BASEBOARD);
+    table.string("Dell Inc.");
+    table.string("06WXJT");
+    table.string("A01");
+    table.string("." + serviceTag(serial) + ".CNFCP0099N0123.");
+    table.string("Not Specified");
+    table.byte(0x09);
+    table.string("Not Specified");
+    table.word(3);
+    table.byte(0x0A);
+    table.byte(0);
+    table.end();
+
+    table.begin(DMI_TYPE_SYSENCLOSURE);
+    table.string("Dell Inc.");
+    table.byte(0x17);
+    table.string("Not Specified");
+    table.string(serviceTag(serial));
+    table.string("Not Specified");
+    table.byte(3);
+    table.byte(3);
+    table.byte(3);
+    table.byte(3);
+    table.dword(0x01010200);
+    table.byte(2);
+    table.byte(2);
+    table.byte(0);
+    table.byte(3);
+    table.string("SKU Number");
+    table.end();
+
+    for (int socket = 0; socket < sockets; ++socket)
+    {
+        static const struct
+        {
+            uint16_t configuration;
+            uint32_t size;  // KiB
+            uint8_t type;
+            uint8_t associativity;
+        } CACHES[3] = { { 0x0180, 1280, 0x04, 0x07 }, { 0x0181, 32768, 0x05, 0x07 }, { 0x0182, 39424, 0x05, 0x09 } };
+
+        uint16_t handles[3];
+        for (int level = 0; level < 3; ++level)
+        {
+            uint32_t size = CACHES[level].size;
+            uint16_t legacy = (size >= 0x8000) ? (uint16_t) (0x8000 | (size / 64)) : (uint16_t) size;
+            handles[level] = table.begin(DMI_TYPE_CACHE);
+            table.string("L" + std::to_string(level + 1) + " Cache");
+            table.word(CACHES[level].configuration);
+            table.word(legacy);
+            table.word(legacy);
+            table.word(0x0040);
+            table.word(0x0040);
+            table.byte(0);
+            table.byte(0x06);
+            table.byte(CACHES[level].type);
+            table.byte(CACHES[level].associativity);
+            table.dword(size);
+            table.dword(size);
+            table.end();
+        }
+
+        table.begin(DMI_TYPE_PROCESSOR);
+        table.string("CPU" + std::to_string(socket + 1));
+        table.byte(0x03);
+        table.byte(0xB3);
+        table.string("Intel");
+        table.qword(0xBFEBFBFF00050654ULL);
+        table.string("Intel(R) Xeon(R) Gold 6248R CPU @ 3.00GHz");
+        table.byte(0x8C);
+        table.word(100);
+        table.word(4000);
+        table.word(3000);
+        table.byte(0x41);
+        table.byte(0x3F);
+        table.word(handles[0]);
+        table.word(handles[1]);
+        table.word(handles[2]);
+        table.string("Not Specified");
+        table.string("Not Specified");
+        table.string("Not Specified");
+        table.byte(24);
+        table.byte(24);
+        table.byte(48);
+        table.word(0x00FC);
+        table.word(0x00B3);
+        table.word(24);
+        table.word(24);
+        table.word(48);
+        table.end();
+    }
+
+    for (int slot = 0; slot < 4; ++slot)
+    {
+        table.begin(DMI_TYPE_SYSSLOT);
+        table.string("PCIe Slot " + std::to_string(slot + 1));
+        table.byte(0xAB);
+        table.byte(0x0D);
+        table.byte(0x03);
+        table.byte(0x04);
+        table.word((uint16_t) (slot + 1));
+        table.byte(0x04);
+        table.byte(0x01);
+        table.word(0);
+        table.byte((uint8_t) (0x17 + slot * 0x20));
+        table.byte(0);
+        table.end();
+    }
+
+    table.begin(DMI_TYPE_OEMSTRINGS);
+    table.byte(3);
+    table.add("Dell System");
+    table.add("1[08DC]");
+    table.add("3[1.0]");
+    table.end();
+
+    uint16_t array = table.begin(DMI_TYPE_PHYSMEM);
+    table.byte(0x03);
+    table.byte(0x03);
+    table.byte(0x06);
+    table.dword(0x80000000);
+    table.word(0xFFFE);
+    table.word((uint16_t) dimms);
+    table.qword(0x0000000180000000ULL);
+    table.end();
+
+    for (int dimm = 0; dimm < dimms; ++dimm)
+    {
+        table.begin(DMI_TYPE_MEMORY);
+        table.word(array);
+        table.word(0xFFFE);
+        table.word(72);
+        table.word(64);
+        table.word(32768);
+        table.byte(0x09);
+        table.byte(0);
+        table.string(std::string("A") + std::to_string(dimm + 1));
+        table.string("Not Specified");
+        table.byte(0x1A);
+        table.word(0x0080);
+        table.word(2933);
+        table.string("00AD063200AD");
+        table.string(std::to_string(1234 + serial) + std::to_string(10000 + dimm));
+        table.string("01193021");
+        table.string("HMA84GR7CJR4N-WM");
+        table.byte(0x02);
+        table.dword(0);
+        table.word(2933);
+        table.word(1200);
+        table.word(1200);
+        table.word(1200);
+        table.end();
+    }
+
+    table.begin(DMI_TYPE_ENDOFTABLE);
+    table.end();
+
+    // SMBIOS 3.1 entry point in front of the table, as 'getDMI' lays it out
+    size_t length = buffer.size() - 32;
+    static const uint8_t ENTRY_POINT[] = { '_', 'S', 'M', '3', '_', 0, 0x18, 3, 1, 0, 0x01, 0 };
+    memcpy(buffer.data(), ENTRY_POINT, sizeof(ENTRY_POINT));
+    for (int i = 0; i < 4; ++i) buffer[12 + i] = (uint8_t) (length >> (i * 8));
+    uint8_t checksum = 0;
+    for (int i = 0; i < 0x18; ++i) checksum = (uint8_t) (checksum + buffer[i]);
+    buffer[5] = (uint8_t) -checksum;
+}
+
+bool runBenchmark( const std::vector<BenchTable> &tables, const BenchOptions &options,
+    std::vector<BenchResult> &results, std::string *counterError )
+{
+    PerfCounters counters(options.counters);
+    if (counterError != NULL) *counterError = counters.error();
+
+    // a batch of one: the stage measures what loading a single dump costs
+    BulkOptions bulkOptions;
+    bulkOptions.batchSize = 1;
+    BulkReader bulk(bulkOptions);
+
+    bool valid = true;
+    for (size_t t = 0; t < tables.size(); ++t)
+    {
+        Parser parser(tables[t].data.data(), tables[t].data.size());
+        if (!parser.valid())
+        {
+            valid = false;
+            continue;
+        }
+
+        uint64_t count = 0;
+        Structures range = structures(parser);
+        for (StructureIterator it = range.begin(); it != range.end(); ++it) ++count;
+
+        IndexBuilder index;
+        StageContext context;
+        context.name = &tables[t].name;
+        context.parser = &parser;
+        context.index = &index;
+        context.bulk = &bulk;
+        if (options.stages & (1U << BENCH_BULK))
+        {
+            std::string path = writeTempFile(options.tempDirectory, tables[t].data);
+            if (!path.empty()) context.files.push_back(path);
+        }
+
+        for (int stage = 0; stage < BENCH_STAGES; ++stage)
+        {
+            if ((options.stages & (1U << stage)) == 0) continue;
+            if (stage == BENCH_BULK && context.files.empty()) continue;
+
+            // warm-up: caches, branch predictors and the lazily bound symbols
+            runStage(stage, context);
+
+            BenchResult result;
+            result.table = tables[t].name;
+            result.stage = stage;
+            result.structures = count;
+            result.bytes = parser.size();
+            result.iterations = options.iterations;
+
+            counters.start();
+            for (size_t i = 0; i < options.iterations; ++i)
+                runStage(stage, context);
+            counters.stop(result.counters);
+            results.push_back(result);
+        }
+
+        for (size_t i = 0; i < context.files.size(); ++i) unlink(context.files[i].c_str());
+    }
+    return valid;
+}
+
+static void printRatio( std::ostream &output, int width, bool valid, double value, double divisor )
+{
+    output << std::setw(width);
+    if (valid && divisor > 0)
+        output << value / divisor;
+    else
+        output << '-';
+}
+
+void printBenchmark( const std::vector<BenchResult> &results, std::ostream &output )
+{
+    std::ios_base::fmtflags flags = output.flags();
+    std::streamsize precision = output.precision();
+    output << std::fixed << std::setprecision(2);
+
+    output << std::left << std::setw(16) << "table" << std::setw(9) << "stage" << std::right
+        << std::setw(8) << "structs" << std::setw(8) << "bytes"
+        << " |" << std::setw(10) << "ns/st" << std::setw(10) << "cyc/st" << std::setw(10) << "ins/st"
+        << std::setw(6) << "IPC" << std::setw(9) << "brm/st" << std::setw(9) << "L1D/st" << std::setw(9) << "LLC/st"
+        << " |" << std::setw(8) << "ns/B" << std::setw(8) << "cyc/B" << std::setw(8) << "ins/B"
+        << std::setw(8) << "brm/kB" << '\n';
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult &result = results[i];
+        const CounterValues &counters = result.counters;
+        double structures = (double) result.structures * (double) result.iterations;
+        double bytes = (double) result.bytes * (double) result.iterations;
+        double nanoseconds = counters.wall * 1e9;
+
+        output << std::left << std::setw(16) << result.table.substr(0, 15) << std::setw(9) << benchStageName(result.stage)
+            << std::right << std::setw(8) << result.structures << std::setw(8) << result.bytes << " |";
+        printRatio(output, 10, true, nanoseconds, structures);
+        printRatio(output, 10, counters.valid[PERF_CYCLES], (double) counters.values[PERF_CYCLES], structures);
+        printRatio(output, 10, counters.valid[PERF_INSTRUCTIONS], (double) counters.values[PERF_INSTRUCTIONS], structures);
+        printRatio(output, 6, counters.valid[PERF_CYCLES] && counters.valid[PERF_INSTRUCTIONS],
+            (double) counters.values[PERF_INSTRUCTIONS], (double) counters.values[PERF_CYCLES]);
+        printRatio(output, 9, counters.valid[PERF_BRANCH_MISSES], (double) counters.values[PERF_BRANCH_MISSES], structures);
+        printRatio(output, 9, counters.valid[PERF_L1D_MISSES], (double) counters.values[PERF_L1D_MISSES], structures);
+        printRatio(output, 9, counters.valid[PERF_LLC_MISSES], (double) counters.values[PERF_LLC_MISSES], structures);
+        output << " |";
+        printRatio(output, 8, true, nanoseconds, bytes);
+        printRatio(output, 8, counters.valid[PERF_CYCLES], (double) counters.values[PERF_CYCLES], bytes);
+        printRatio(output, 8, counters.valid[PERF_INSTRUCTIONS], (double) counters.values[PERF_INSTRUCTIONS], bytes);
+        printRatio(output, 8, counters.valid[PERF_BRANCH_MISSES], (double) counters.values[PERF_BRANCH_MISSES], bytes / 1024);
+        output << '\n';
+    }
+
+    // the iterator is meant to cost no more than the 'next' loop it replaces
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        if (results[i].stage != BENCH_NEXT || results[i].counters.wall <= 0) continue;
+        for (size_t j = 0; j < results.size(); ++j)
+        {
+            if (results[j].stage != BENCH_ITERATE || results[j].table != results[i].table) continue;
+            output << results[i].table << ": iterate takes "
+                << results[j].counters.wall / results[i].counters.wall * 100 << "% of the time of next\n";
+        }
+    }
+
+    output.flags(flags);
+    output.precision(precision);
+}
+
+bool measureStartup( const std::vector<std::string> &command, size_t runs, StartupResult &result )
+{
+    result.binary = command.empty() ? std::string() : command[0];
+    result.size = result.output = result.runs = 0;
+    result.firstOutput = result.exit = 0;
+    struct stat info;
+    if (command.empty() || runs == 0 || stat(command[0].c_str(), &info) != 0) return false;
+    result.size = (uint64_t) info.st_size;
+
+    std::vector<char*> argv;
+    for (size_t i = 0; i < command.size(); ++i) argv.push_back((char*) command[i].c_str());
+    argv.push_back(NULL);
+
+    uint64_t firstOutput = 0, exit = 0;
+    for (size_t run = 0; run < runs; ++run)
+    {
+        int fds[2];
+        if (pipe(fds) != 0) return false;
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], 1);
+        posix_spawn_file_actions_addclose(&actions, fds[0]);
+        posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+        pid_t pid;
+        uint64_t start = nowNanoseconds();
+        int error = posix_spawn(&pid, argv[0], &actions, NULL, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(fds[1]);
+        if (error != 0)
+        {
+            close(fds[0]);
+            return false;
+        }
+
+        // the pipe stays open until the process exits, so EOF comes right before it
+        char buffer[64 * 1024];
+        uint64_t first = 0, output = 0;
+        while (true)
+        {
+            ssize_t count = read(fds[0], buffer, sizeof(buffer));
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) break;
+            if (output == 0) first = nowNanoseconds();
+            output += (uint64_t) count;
+        }
+        close(fds[0]);
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR);
+        uint64_t end = nowNanoseconds();
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || output == 0) return false;
+
+        firstOutput += first - start;
+        exit += end - start;
+        result.output = output;
+        ++result.runs;
+    }
+
+    result.firstOutput = (double) firstOutput / 1e9 / (double) result.runs;
+    result.exit = (double) exit / 1e9 / (double) result.runs;
+    return true;
+}
+
+void printStartup( const std::vector<StartupResult> &results, std::ostream &output )
+{
+    std::ios_base::fmtflags flags = output.flags();
+    std::streamsize precision = output.precision();
+    output << std::fixed << std::setprecision(1);
+
+    output << std::left << std::setw(24) << "binary" << std::right << std::setw(10) << "size"
+        << std::setw(8) << "runs" << std::setw(8) << "output" << std::setw(12) << "first us" << std::setw(12) << "exit us" << '\n';
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const StartupResult &result = results[i];
+        size_t pos = result.binary.find_last_of('/');
+        std::string name = (pos == std::string::npos) ? result.binary : result.binary.substr(pos + 1);
+        output << std::left << std::setw(24) << name.substr(0, 23) << std::right << std::setw(10) << result.size
+            << std::setw(8) << result.runs << std::setw(8) << result.output
+            << std::setw(12) << result.firstOutput * 1e6 << std::setw(12) << result.exit * 1e6 << '\n';
+    }
+
+    output.flags(flags);
+    output.precision(precision);
+}
+
+bool measureLoaders( const std::vector<uint8_t> &table, size_t files, const std::string &directory,
+    std::vector<LoaderResult> &results )
+{
+    results.clear();
+    if (table.size() <= DMI_EP_SIZE || files == 0) return false;
+    std::string root = directory + "/smbios-loader-XXXXXX";
+    if (mkdtemp(&root[0]) == NULL) return false;
+
+    // the same dumps twice: as sysfs directories for 'getDMI' and as single files for 'BulkReader'
+    std::vector<std::string> dirs, paths;
+    bool ok = true;
+    for (size_t i = 0; i < files && ok; ++i)
+    {
+        char name[24];
+        snprintf(name, sizeof(name), "/%07u", (unsigned) i);
+        dirs.push_back(root + name);
+        paths.push_back(root + name + ".bin");
+        ok = mkdir(dirs.back().c_str(), 0700) == 0 &&
+            writeFile(dirs.back() + "/smbios_entry_point", table.data(), DMI_EP_SIZE) &&
+            writeFile(dirs.back() + "/DMI", table.data() + DMI_EP_SIZE, table.size() - DMI_EP_SIZE) &&
+            writeFile(paths.back(), table.data(), table.size());
+    }
+
+    uint64_t total = 0;
+    if (ok)
+    {
+        // the files were just written, so all of them are in the page cache
+        LoaderResult result;
+        result.method = "getDMI";
+        result.files = result.bytes = 0;
+        result.available = true;
+        std::vector<uint8_t> buffer;
+        uint64_t start = nowNanoseconds();
+        for (size_t i = 0; i < dirs.size(); ++i)
+        {
+            if (!getDMI(dirs[i], buffer)) continue;
+            Parser parser(buffer.data(), buffer.size());
+            if (!parser.valid()) continue;
+            total += walkDump(parser);
+            ++result.files;
+            result.bytes += buffer.size();
+        }
+        result.wall = (double) (nowNanoseconds() - start) / 1e9;
+        results.push_back(result);
+
+        for (int uring = 0; uring < 2; ++uring)
+        {
+            BulkOptions options;
+            options.useIoUring = uring != 0;
+            BulkReader reader(options);
+            result.method = uring ? "bulk-io_uring" : "bulk-pread";
+            result.files = result.bytes = 0;
+            result.wall = 0;
+            // without io_uring the reader would just measure pread again
+            result.available = !uring || reader.usingIoUring();
+            if (result.available)
+            {
+                BulkStats stats;
+                reader.read(paths, [&total]( const std::string &path, Parser &parser )
+                    {
+                        (void) path;
+                        total += walkDump(parser);
+                    }, stats);
+                result.files = stats.files - stats.invalid;
+                result.bytes = stats.bytes;
+                result.wall = stats.wall;
+            }
+            results.push_back(result);
+        }
+    }
+
+    for (size_t i = 0; i < dirs.size(); ++i)
+    {
+        unlink((dirs[i] + "/smbios_entry_point").c_str());
+        unlink((dirs[i] + "/DMI").c_str());
+        rmdir(dirs[i].c_str());
+        unlink(paths[i].c_str());
+    }
+    rmdir(root.c_str());
+    sink = sink + total;
+    return ok;
+}
+
+bool measureIndex( size_t tables, size_t queries, const std::string &directory, IndexResult &result )
+{
+    memset(&result, 0, sizeof(result));
+    if (tables == 0 || queries == 0) return false;
+    result.tables = tables;
+    result.queries = queries;
+
+    // machines of 1 to 4 sockets, each with its own serial numbers
+    IndexBuilder builder;
+    std::vector<uint8_t> buffer;
+    uint64_t elapsed = 0;
+    for (size_t i = 0; i < tables; ++i)
+    {
+        int sockets = 1 + (int) (i % 4);
+        makeSyntheticTable(sockets, sockets * 4, buffer, false, (uint32_t) i + 1);
+        uint64_t start = nowNanoseconds();
+        Parser parser(buffer.data(), buffer.size());
+        builder.addTable("machine-" + std::to_string(i), parser);
+        elapsed += nowNanoseconds() - start;
+    }
+    result.build = (double) elapsed / 1e9;
+    result.terms = builder.terms();
+
+    std::string path = writeTempFile(directory, std::vector<uint8_t>());
+    if (path.empty()) return false;
+    uint64_t start = nowNanoseconds();
+    bool ok = builder.write(path);
+    result.write = (double) (nowNanoseconds() - start) / 1e9;
+
+    Index index;
+    struct stat info;
+    ok = ok && stat(path.c_str(), &info) == 0 && index.open(path);
+    unlink(path.c_str());
+    if (!ok) return false;
+    result.fileSize = (uint64_t) info.st_size;
+
+    // a service tag matches exactly one machine; the prefix and AND queries match all of them
+    uint64_t total = 0;
+    IndexTerm tag = { DMI_TYPE_SYSINFO, 0x07, std::string(), false };
+    start = nowNanoseconds();
+    for (size_t i = 0; i < queries; ++i)
+    {
+        uint32_t id = (uint32_t) ((i * 7919) % tables);
+        tag.value = serviceTag(id + 1);
+        std::vector<uint32_t> ids = index.find(tag);
+        if (ids.size() != 1 || ids[0] != id) ok = false;
+        total += ids.size();
+    }
+    result.exact = (double) (nowNanoseconds() - start) / 1e9 / (double) queries;
+
+    IndexTerm cpu = { DMI_TYPE_PROCESSOR, 0x10, "Intel(R) Xeon(R)", true };
+    start = nowNanoseconds();
+    for (size_t i = 0; i < queries; ++i) total += index.find(cpu).size();
+    result.prefix = (double) (nowNanoseconds() - start) / 1e9 / (double) queries;
+
+    std::vector<IndexTerm> model;
+    IndexTerm vendor = { DMI_TYPE_SYSINFO, 0x04, "Dell Inc.", false };
+    IndexTerm product = { DMI_TYPE_SYSINFO, 0x05, "PowerEdge R740", false };
+    model.push_back(vendor);
+    model.push_back(product);
+    start = nowNanoseconds();
+    for (size_t i = 0; i < queries; ++i) total += index.findAll(model).size();
+    result.all = (double) (nowNanoseconds() - start) / 1e9 / (double) queries;
+
+    sink = sink + total;
+    return ok;
+}
+
+bool measureIngest( size_t archives, size_t tables, const std::string &directory,
+    const IngestOptions &options, IngestStats &stats )
+{
+    memset(&stats, 0, sizeof(stats));
+    if (archives == 0 || tables == 0) return false;
+    std::string root = directory + "/smbios-ingest-XXXXXX";
+    if (mkdtemp(&root[0]) == NULL) return false;
+
+    // machines of 1 to 4 sockets, each archive holding 'tables' sysfs directories
+    std::vector<std::string> paths;
+    std::vector<uint8_t> buffer;
+    bool ok = true;
+    for (size_t i = 0; i < archives && ok; ++i)
+    {
+        char name[24];
+        snprintf(name, sizeof(name), "/%06u.tar.gz", (unsigned) i);
+        paths.push_back(root + name);
+        gzFile file = gzopen(paths.back().c_str(), "wb6");
+        if (file == NULL)
+        {
+            ok = false;
+            break;
+        }
+        for (size_t j = 0; j < tables && ok; ++j)
+        {
+            uint32_t serial = (uint32_t) (i * tables + j + 1);
+            int sockets = 1 + (int) (serial % 4);
+            makeSyntheticTable(sockets, sockets * 4, buffer, false, serial);
+            std::string dir = "dmi-" + std::to_string(serial) + "/tables/";
+            ok = writeTarMember(file, dir + "smbios_entry_point", buffer.data(), DMI_EP_SIZE) &&
+                writeTarMember(file, dir + "DMI", buffer.data() + DMI_EP_SIZE, buffer.size() - DMI_EP_SIZE);
+        }
+        // two zero blocks end the archive
+        static const uint8_t END[1024] = { 0 };
+        ok = gzwrite(file, END, sizeof(END)) == (int) sizeof(END) && ok;
+        ok = gzclose(file) == Z_OK && ok;
+    }
+
+    if (ok)
+    {
+        // the handler does what a consumer at least does: walk every structure
+        std::atomic<uint64_t> total(0);
+        ok = ingestArchives(paths, [&total]( const std::string &name, Parser &parser )
+            {
+                (void) name;
+                total += walkDump(parser);
+            }, stats, options);
+        ok = ok && stats.parse.items == archives * tables && stats.invalidTables == 0;
+        sink = sink + total;
+    }
+
+    for (size_t i = 0; i < paths.size(); ++i)
+        unlink(paths[i].c_str());
+    rmdir(root.c_str());
+    return ok;
+}
+
+bool checkStream( const std::vector<BenchTable> &tables, std::ostream &output )
+{
+    static const size_t CHUNKS[] = { 1, 2, 3, 4, 5, 7, 16, 31, 32, 33, 64, 4096 };
+    const size_t RANDOM_RUNS = 16;
+    std::mt19937 random(7);
+    uint64_t runs = 0;
+    uint64_t mismatches = 0;
+
+    std::vector<BenchTable> variants;
+    for (size_t t = 0; t < tables.size(); ++t)
+    {
+        variants.push_back(tables[t]);
+        BenchTable shortened;
+        shortened.name = tables[t].name + "-short";
+        shortened.data = shortenStructures(tables[t].data, 5);
+        variants.push_back(shortened);
+    }
+
+    for (size_t t = 0; t < variants.size(); ++t)
+    {
+        std::vector<std::string> expected = describeTable(variants[t].data);
+        size_t count = sizeof(CHUNKS) / sizeof(CHUNKS[0]) + RANDOM_RUNS;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t chunk = (i < sizeof(CHUNKS) / sizeof(CHUNKS[0])) ? CHUNKS[i] : 0;
+            std::vector<std::string> actual = describeStream(variants[t].data, chunk, random);
+            ++runs;
+            if (actual == expected) continue;
+            ++mismatches;
+            output << "[stream] mismatch:" << variants[t].name << " chunk " << chunk << " ("
+                << actual.size() << " structures, expected " << expected.size() << ")\n";
+        }
+    }
+
+    output << "[stream] tables:" << variants.size() << '\n';
+    output << "[stream] runs:" << runs << '\n';
+    output << "[stream] mismatches:" << mismatches << '\n';
+    return mismatches == 0;
+}
+
+void printIndex( const IndexResult &result, std::ostream &output )
+{
+    std::ios_base::fmtflags flags = output.flags();
+    std::streamsize precision = output.precision();
+    output << std::fixed << std::setprecision(2);
+
+    output << "[index] tables:" << result.tables << '\n';
+    output << "[index] terms:" << result.terms << '\n';
+    output << "[index] file_bytes:" << result.fileSize << '\n';
+    output << "[index] bytes_per_table:" << (double) result.fileSize / (double) result.tables << '\n';
+    output << "[index] build_us_per_table:" << result.build * 1e6 / (double) result.tables << '\n';
+    output << "[index] write_ms:" << result.write * 1e3 << '\n';
+    output << "[index] exact_query_us:" << result.exact * 1e6 << '\n';
+    output << "[index] prefix_query_us:" << result.prefix * 1e6 << '\n';
+    output << "[index] and_query_us:" << result.all * 1e6 << '\n';
+
+    output.flags(flags);
+    output.precision(precision);
+}
+
+void printLoaders( const std::vector<LoaderResult> &results, std::ostream &output )
+{
+    std::ios_base::fmtflags flags = output.flags();
+    std::streamsize precision = output.precision();
+    output << std::fixed << std::setprecision(1);
+
+    output << std::left << std::setw(16) << "method" << std::right << std::setw(10) << "files"
+        << std::setw(12) << "files/s" << std::setw(10) << "MiB/s" << std::setw(10) << "speedup" << '\n';
+    double baseline = (!results.empty() && results[0].wall > 0) ? (double) results[0].files / results[0].wall : 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const LoaderResult &result = results[i];
+        output << std::left << std::setw(16) << result.method << std::right;
+        if (!result.available || result.wall <= 0)
+        {
+            output << std::setw(10) << "-" << "  unavailable\n";
+            continue;
+        }
+        double rate = (double) result.files / result.wall;
+        output << std::setw(10) << result.files << std::setw(12) << rate
+            << std::setw(10) << (double) result.bytes / result.wall / (1024 * 1024);
+        if (baseline > 0)
+            output << std::setw(9) << rate / baseline << 'x';
+        output << '\n';
+    }
+
+    output.flags(flags);
+    output.precision(precision);
+}
+
+} // namespace smbios
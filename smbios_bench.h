@@ -0,0 +1,235 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SMBIOS_BENCH_HH
+#define SMBIOS_BENCH_HH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "smbios_archive.h"
+
+/*
+ * Benchmark runner for the parser, the emitters and the tooling built on them
+ * (topology, index, bulk loader, archive ingestion); 'bench_main.cpp' is its
+ * command line.
+ *
+ * Each stage (see 'BENCH_STAGES') runs over every table for a number of
+ * iterations, timed by the wall clock and, when the kernel allows it, by
+ * hardware counters read through perf_event_open. The results are reported
+ * per structure and per byte of table. Where the counters cannot be opened
+ * (no PMU in the VM, perf_event_paranoid, seccomp in containers) only the
+ * wall-clock figures are reported.
+ */
+
+namespace smbios {
+
+enum PerfCounter
+{
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_COUNTERS
+};
+
+struct CounterValues
+{
+    uint64_t values[PERF_COUNTERS];  // scaled up if the kernel multiplexed the counters
+    bool valid[PERF_COUNTERS];
+    double wall;                     // seconds
+};
+
+// Group of user-space counters for the calling thread
+class PerfCounters
+{
+    public:
+        // 'open' false only measures the wall clock
+        PerfCounters( bool open = true );
+        ~PerfCounters();
+
+        // true if at least one hardware counter could be opened
+        bool available() const;
+        bool available( int counter ) const;
+        // why no counter is available (empty if some are)
+        const std::string &error() const;
+
+        void start();
+        void stop( CounterValues &values );
+
+    private:
+        int fds_[PERF_COUNTERS];
+        int leader_;
+        std::string error_;
+        uint64_t start_;
+
+        PerfCounters( const PerfCounters& );
+        PerfCounters &operator=( const PerfCounters& );
+};
+
+const char *perfCounterName( int counter );
+
+// What each stage measures
+enum BenchStage
+{
+    BENCH_NEXT = 0,  // Parser::next (walk and decode every structure)
+    BENCH_ITERATE,   // range-for over 'structures', decoding every structure
+    BENCH_STRINGS,   // every string of every structure
+    BENCH_SANITIZE,  // sanitizeString over every string of every structure
+    BENCH_TOPOLOGY,  // getTopology
+    BENCH_EMIT,      // emitSMBIOS into a counting sink
+    BENCH_PRINT,     // printSMBIOS into an ostream
+    BENCH_INDEX,     // IndexBuilder::addTable (one builder per table, so terms repeat)
+    BENCH_BULK,      // BulkReader loading the table from a file and Parser::next over it
+    BENCH_STAGES
+};
+
+const char *benchStageName( int stage );
+// Stage with the given name (BENCH_STAGES if none)
+int benchStage( const char *name );
+
+struct BenchTable
+{
+    std::string name;
+    std::vector<uint8_t> data;  // any layout 'Parser' detects
+};
+
+struct BenchOptions
+{
+    size_t iterations;          // per table and stage (after one warm-up run)
+    bool counters;              // false skips perf_event_open entirely
+    uint32_t stages;            // bit mask of the stages to run (1 << BENCH_NEXT | ...)
+    std::string tempDirectory;  // where BENCH_BULK writes the tables it loads
+
+    BenchOptions();
+};
+
+struct BenchResult
+{
+    std::string table;
+    int stage;
+    uint64_t structures;  // per iteration
+    uint64_t bytes;       // per iteration
+    uint64_t iterations;
+    CounterValues counters;
+};
+
+/*
+ * Builds a SMBIOS 3.1 table (with its entry point) with the usual system
+ * structures, three caches per socket and the given number of DIMMs. With
+ * 'dirty', every string gets padding, 0xFF filler, control or non-ASCII bytes
+ * (the corpus for the SANITIZE and EMIT stages). 'serial' changes the service
+ * tag and the DIMM serial numbers, to tell the machines of a corpus apart.
+ */
+void makeSyntheticTable( int sockets, int dimms, std::vector<uint8_t> &buffer, bool dirty = false,
+    uint32_t serial = 0 );
+
+// Dell service tag 'makeSyntheticTable' gives the machine with that serial
+std::string serviceTag( uint32_t serial );
+
+// Returns false if any table is not valid (the valid ones are still measured)
+bool runBenchmark( const std::vector<BenchTable> &tables, const BenchOptions &options,
+    std::vector<BenchResult> &results, std::string *counterError = NULL );
+
+void printBenchmark( const std::vector<BenchResult> &results, std::ostream &output );
+
+struct StartupResult
+{
+    std::string binary;
+    uint64_t size;       // bytes on disk
+    uint64_t output;     // bytes printed by a run
+    uint64_t runs;
+    double firstOutput;  // mean seconds from spawning the process to its first byte of output
+    double exit;         // mean seconds from spawning the process to its exit
+};
+
+/*
+ * Startup-to-output latency of a collector: runs 'command' (the binary, then
+ * its arguments) 'runs' times with the output going to a pipe. Returns false
+ * if it cannot be started or a run exits with an error.
+ */
+bool measureStartup( const std::vector<std::string> &command, size_t runs, StartupResult &result );
+
+void printStartup( const std::vector<StartupResult> &results, std::ostream &output );
+
+struct LoaderResult
+{
+    std::string method;
+    uint64_t files;  // valid dumps loaded
+    uint64_t bytes;
+    double wall;     // seconds for all of them, walking every structure included
+    bool available;  // false if the method cannot run here (no io_uring)
+};
+
+/*
+ * Files per second of the ways to load many small dumps: 'getDMI' over
+ * directories laid out as /sys/firmware/dmi/tables, then 'BulkReader' with
+ * pread and with io_uring over single-file dumps. 'files' copies of 'table'
+ * (in the 'getDMI' layout) are written to a new directory under 'directory'
+ * and removed afterwards.
+ */
+bool measureLoaders( const std::vector<uint8_t> &table, size_t files, const std::string &directory,
+    std::vector<LoaderResult> &results );
+
+void printLoaders( const std::vector<LoaderResult> &results, std::ostream &output );
+
+struct IndexResult
+{
+    uint64_t tables;
+    uint64_t terms;
+    uint64_t fileSize;
+    uint64_t queries;  // of each kind
+    double build;      // seconds in 'IndexBuilder::addTable' for all the tables
+    double write;      // seconds in 'IndexBuilder::write'
+    double exact;      // mean seconds per query: a service tag (one match)
+    double prefix;     // a processor version prefix (every table)
+    double all;        // vendor AND product (every table)
+};
+
+/*
+ * Builds an index over 'tables' synthetic machines, writes it to a file in
+ * 'directory' (removed afterwards), maps it and runs 'queries' queries of each
+ * kind. Returns false if anything fails or an exact query finds the wrong table.
+ */
+bool measureIndex( size_t tables, size_t queries, const std::string &directory, IndexResult &result );
+
+void printIndex( const IndexResult &result, std::ostream &output );
+
+/*
+ * Runs 'ingestArchives' over 'archives' .tar.gz files of 'tables' synthetic
+ * machines each, stored in the /sys/firmware/dmi/tables layout. The archives
+ * are written to a new directory under 'directory' and removed afterwards.
+ * Returns false if anything fails or a table is lost on the way.
+ */
+bool measureIngest( size_t archives, size_t tables, const std::string &directory,
+    const IngestOptions &options, IngestStats &stats );
+
+/*
+ * Equivalence test of 'StreamParser' against 'Parser' over the whole buffer.
+ * Each table, and a copy whose structures are shorter than their version
+ * defines, is fed in chunks of 1 byte to 4 KiB and of random sizes; every run
+ * must hand over the same structures with the same decoded fields. Prints a
+ * line per mismatch and the totals; returns false if there is any mismatch.
+ */
+bool checkStream( const std::vector<BenchTable> &tables, std::ostream &output );
+
+} // namespace smbios
+
+#endif // SMBIOS_BENCH_HH
@@ -0,0 +1,423 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "smbios_bulk.h"
+#include <chrono>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace smbios {
+
+BulkOptions::BulkOptions() : batchSize(256), bufferSize(64 * 1024), useIoUring(true)
+{
+}
+
+#ifdef __linux__
+
+/*
+ * Minimal io_uring driver on top of the raw system calls (no liburing).
+ * Only what the loader needs: fill a batch of SQEs, submit them and wait for
+ * all completions with a single io_uring_enter.
+ */
+struct BulkReader::Ring
+{
+    int fd;
+    unsigned entries;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    io_uring_sqe *sqes;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    io_uring_cqe *cqes;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+    unsigned pending;
+
+    Ring() : fd(-1), entries(0), sqes((io_uring_sqe*) MAP_FAILED), sqRing(MAP_FAILED), cqRing(MAP_FAILED),
+        pending(0) {}
+
+    ~Ring()
+    {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        if (fd >= 0) close(fd);
+    }
+
+    bool setup( unsigned count )
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd = (int) syscall(__NR_io_uring_setup, count, &params);
+        if (fd < 0) return false;
+        entries = params.sq_entries;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single && cqRingSize > sqRingSize) sqRingSize = cqRingSize;
+
+        sqRing = mmap(NULL, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) return false;
+        cqRing = single ? sqRing : mmap(NULL, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) return false;
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe*) mmap(NULL, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+
+        uint8_t *sq = (uint8_t*) sqRing;
+        uint8_t *cq = (uint8_t*) cqRing;
+        sqTail = (unsigned*) (sq + params.sq_off.tail);
+        sqMask = (unsigned*) (sq + params.sq_off.ring_mask);
+        sqArray = (unsigned*) (sq + params.sq_off.array);
+        cqHead = (unsigned*) (cq + params.cq_off.head);
+        cqTail = (unsigned*) (cq + params.cq_off.tail);
+        cqMask = (unsigned*) (cq + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe*) (cq + params.cq_off.cqes);
+
+        return supports(IORING_OP_OPENAT) && supports(IORING_OP_READ) && supports(IORING_OP_CLOSE);
+    }
+
+    bool supports( int op )
+    {
+        const unsigned OPS = 256;
+        std::vector<uint8_t> buffer(sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op), 0);
+        io_uring_probe *probe = (io_uring_probe*) buffer.data();
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, OPS) < 0) return false;
+        return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+    io_uring_sqe *next()
+    {
+        unsigned tail = *sqTail + pending;
+        unsigned index = tail & *sqMask;
+        sqArray[index] = index;
+        ++pending;
+        io_uring_sqe *sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    int enter( unsigned submit, unsigned wait )
+    {
+        return (int) syscall(__NR_io_uring_enter, fd, submit, wait, IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+
+    /*
+     * Submits the queued SQEs, waits for all of them and stores each result in
+     * 'results[user_data]'. On failure it still waits for every SQE the kernel
+     * took, so nothing writes into the caller's buffers once it returns.
+     */
+    bool submitAndWait( std::vector<int64_t> &results )
+    {
+        unsigned count = pending;
+        if (count == 0) return true;
+        __atomic_store_n(sqTail, *sqTail + count, __ATOMIC_RELEASE);
+        pending = 0;
+
+        // the kernel may take fewer SQEs than offered; the rest stay queued and are offered again
+        unsigned submitted = 0;
+        unsigned done = 0;
+        bool failed = false;
+        while (done < (failed ? submitted : count))
+        {
+            if (failed)
+                enter(0, submitted - done);
+            else
+            {
+                int rc = enter(count - submitted, count - done);
+                if (rc > 0)
+                    submitted += (unsigned) rc;
+                else
+                if (rc < 0 && errno != EINTR)
+                {
+                    // out of resources: retry once a completion frees some
+                    if ((errno == EAGAIN || errno == EBUSY) && submitted > done)
+                        enter(0, 1);
+                    else
+                        failed = true;
+                }
+            }
+
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head, ++done)
+            {
+                const io_uring_cqe &cqe = cqes[head & *cqMask];
+                results[(size_t) cqe.user_data] = cqe.res;
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        }
+        return !failed;
+    }
+};
+
+#else
+
+struct BulkReader::Ring
+{
+};
+
+#endif
+
+BulkReader::BulkReader( const BulkOptions &options ) : options_(options), ring_(NULL)
+{
+    if (options_.batchSize == 0) options_.batchSize = 1;
+    if (options_.bufferSize == 0) options_.bufferSize = 4096;
+    pool_.resize(options_.batchSize * options_.bufferSize);
+    fds_.resize(options_.batchSize);
+    sizes_.resize(options_.batchSize);
+    results_.resize(options_.batchSize);
+    reading_.reserve(options_.batchSize);
+
+    #ifdef __linux__
+    if (options_.useIoUring)
+    {
+        ring_ = new Ring();
+        if (!ring_->setup((unsigned) options_.batchSize) || ring_->entries < options_.batchSize)
+        {
+            delete ring_;
+            ring_ = NULL;
+        }
+    }
+    #endif
+}
+
+BulkReader::~BulkReader()
+{
+    delete ring_;
+}
+
+bool BulkReader::usingIoUring() const
+{
+    return ring_ != NULL;
+}
+
+bool BulkReader::openAndReadUring( const std::vector<std::string> &paths, size_t first, size_t count )
+{
+    #ifdef __linux__
+    for (size_t i = 0; i < count; ++i)
+    {
+        // stale descriptors from the last batch must not pass for opened ones if the batch fails
+        results_[i] = -ECANCELED;
+        io_uring_sqe *sqe = ring_->next();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (uint64_t) (uintptr_t) paths[first + i].c_str();
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = i;
+    }
+    bool ok = ring_->submitAndWait(results_);
+    // record what was opened even on failure, so 'closeAll' can close it
+    reading_.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        fds_[i] = (results_[i] >= 0) ? (int) results_[i] : -1;
+        // failed opens keep their negative result as the size
+        sizes_[i] = (fds_[i] >= 0) ? 0 : results_[i];
+        if (fds_[i] >= 0) reading_.push_back(i);
+    }
+    if (!ok) return false;
+
+    // a read may return less than asked for; go on from there until EOF or a full slot
+    while (!reading_.empty())
+    {
+        for (size_t j = 0; j < reading_.size(); ++j)
+        {
+            size_t i = reading_[j];
+            io_uring_sqe *sqe = ring_->next();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = fds_[i];
+            sqe->addr = (uint64_t) (uintptr_t) (pool_.data() + i * options_.bufferSize + (size_t) sizes_[i]);
+            sqe->len = (uint32_t) (options_.bufferSize - (size_t) sizes_[i]);
+            sqe->off = (uint64_t) sizes_[i];
+            sqe->user_data = i;
+        }
+        if (!ring_->submitAndWait(results_)) return false;
+
+        size_t kept = 0;
+        for (size_t j = 0; j < reading_.size(); ++j)
+        {
+            size_t i = reading_[j];
+            if (results_[i] < 0)
+                sizes_[i] = results_[i];
+            else
+            if (results_[i] > 0)
+            {
+                sizes_[i] += results_[i];
+                if ((size_t) sizes_[i] < options_.bufferSize) reading_[kept++] = i;
+            }
+        }
+        reading_.resize(kept);
+    }
+    return true;
+    #else
+    (void) paths;
+    (void) first;
+    (void) count;
+    return false;
+    #endif
+}
+
+static int64_t preadFully( int fd, uint8_t *buffer, size_t size, off_t offset )
+{
+    size_t total = 0;
+    while (total < size)
+    {
+        ssize_t count = pread(fd, buffer + total, size - total, offset + (off_t) total);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) return -errno;
+        if (count == 0) break;
+        total += (size_t) count;
+    }
+    return (int64_t) total;
+}
+
+void BulkReader::openAndReadPlain( const std::vector<std::string> &paths, size_t first, size_t count )
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        fds_[i] = open(paths[first + i].c_str(), O_RDONLY | O_CLOEXEC);
+        if (fds_[i] < 0)
+        {
+            sizes_[i] = -errno;
+            continue;
+        }
+        sizes_[i] = preadFully(fds_[i], pool_.data() + i * options_.bufferSize, options_.bufferSize, 0);
+    }
+}
+
+void BulkReader::dispatch( const std::vector<std::string> &paths, size_t first, size_t count,
+    const FileHandler &handler, BulkStats &stats )
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (fds_[i] < 0 || sizes_[i] < 0)
+        {
+            ++stats.failed;
+            continue;
+        }
+
+        const uint8_t *data = pool_.data() + i * options_.bufferSize;
+        size_t size = (size_t) sizes_[i];
+        // the slot is full, so the file may be larger: read all of it on the side
+        if (size == options_.bufferSize)
+        {
+            struct stat info;
+            if (fstat(fds_[i], &info) != 0)
+            {
+                ++stats.failed;
+                continue;
+            }
+            if ((size_t) info.st_size > size)
+            {
+                overflow_.resize((size_t) info.st_size);
+                int64_t result = preadFully(fds_[i], overflow_.data(), overflow_.size(), 0);
+                if (result < 0)
+                {
+                    ++stats.failed;
+                    continue;
+                }
+                data = overflow_.data();
+                size = (size_t) result;
+            }
+        }
+
+        ++stats.files;
+        stats.bytes += size;
+        Parser parser(data, size);
+        if (!parser.valid())
+        {
+            ++stats.invalid;
+            continue;
+        }
+        handler(paths[first + i], parser);
+    }
+}
+
+void BulkReader::closeAll( size_t count )
+{
+    #ifdef __linux__
+    if (ring_ != NULL)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (fds_[i] < 0) continue;
+            io_uring_sqe *sqe = ring_->next();
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = fds_[i];
+            sqe->user_data = i;
+        }
+        if (ring_->submitAndWait(results_))
+        {
+            for (size_t i = 0; i < count; ++i) fds_[i] = -1;
+            return;
+        }
+    }
+    #endif
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (fds_[i] >= 0) close(fds_[i]);
+        fds_[i] = -1;
+    }
+}
+
+bool BulkReader::read( const std::vector<std::string> &paths, const FileHandler &handler, BulkStats &stats )
+{
+    memset(&stats, 0, sizeof(stats));
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (size_t first = 0; first < paths.size(); first += options_.batchSize)
+    {
+        size_t count = paths.size() - first;
+        if (count > options_.batchSize) count = options_.batchSize;
+
+        for (size_t i = 0; i < count; ++i) fds_[i] = -1;
+        if (ring_ == NULL || !openAndReadUring(paths, first, count))
+        {
+            // a failing ring is not retried; close whatever it opened and go on without it
+            if (ring_ != NULL)
+            {
+                delete ring_;
+                ring_ = NULL;
+                closeAll(count);
+            }
+            openAndReadPlain(paths, first, count);
+        }
+        dispatch(paths, first, count, handler, stats);
+        closeAll(count);
+    }
+
+    stats.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats.failed == 0;
+}
+
+} // namespace smbios
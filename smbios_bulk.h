@@ -0,0 +1,98 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SMBIOS_BULK_HH
+#define SMBIOS_BULK_HH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "smbios.h"
+
+/*
+ * Bulk loader for large numbers of small DMI dump files.
+ *
+ * Each file holds a complete dump in any layout 'Parser' detects (see
+ * 'InputFormat'), so dumps taken on Windows and Linux can be mixed.
+ * Files are processed in batches: on Linux the opens, reads and closes of a
+ * whole batch are each submitted through io_uring with a single system call;
+ * where io_uring is unavailable (old kernels, seccomp-restricted containers)
+ * plain open/pread/close is used instead. File contents land in a buffer pool
+ * allocated once per reader and reused for every batch.
+ */
+
+namespace smbios {
+
+struct BulkOptions
+{
+    size_t batchSize;   // files in flight per batch
+    size_t bufferSize;  // bytes per pool slot; larger files are read separately
+    bool useIoUring;
+
+    BulkOptions();
+};
+
+struct BulkStats
+{
+    uint64_t files;
+    uint64_t bytes;
+    uint64_t failed;   // could not be opened or read
+    uint64_t invalid;  // read, but not a valid SMBIOS dump
+    double wall;
+};
+
+// The parser (and the data behind it) is only valid during the call
+typedef std::function<void( const std::string &path, Parser &parser )> FileHandler;
+
+class BulkReader
+{
+    public:
+        BulkReader( const BulkOptions &options = BulkOptions() );
+        ~BulkReader();
+
+        // true if batches go through io_uring (false means the pread fallback)
+        bool usingIoUring() const;
+        bool read( const std::vector<std::string> &paths, const FileHandler &handler, BulkStats &stats );
+
+    private:
+        struct Ring;
+
+        BulkOptions options_;
+        Ring *ring_;
+        std::vector<uint8_t> pool_;
+        std::vector<uint8_t> overflow_;
+        std::vector<int> fds_;
+        std::vector<int64_t> sizes_;
+        // per-SQE results of the ring, and the slots still being read (see 'openAndReadUring')
+        std::vector<int64_t> results_;
+        std::vector<size_t> reading_;
+
+        BulkReader( const BulkReader& );
+        BulkReader &operator=( const BulkReader& );
+
+        bool openAndReadUring( const std::vector<std::string> &paths, size_t first, size_t count );
+        void openAndReadPlain( const std::vector<std::string> &paths, size_t first, size_t count );
+        void dispatch( const std::vector<std::string> &paths, size_t first, size_t count,
+            const FileHandler &handler, BulkStats &stats );
+        void closeAll( size_t count );
+};
+
+} // namespace smbios
+
+#endif // SMBIOS_BULK_HH
@@ -0,0 +1,548 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "smbios_core.h"
+#include "smbios_names.h"
+#include "smbios_strings.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace smbios {
+
+namespace {
+
+struct Hex
+{
+    uint64_t value;
+    int width;  // zero padded to this many digits
+
+    explicit Hex( uint64_t value, int width = 0 ) : value(value), width(width) {}
+};
+
+/*
+ * Formats into a small stack buffer and hands it to the sink only when full,
+ * so the sink sees a few large writes instead of one per field.
+ */
+class Writer
+{
+    public:
+        Writer( const ByteSink &sink ) : sink_(sink), length_(0) {}
+        ~Writer() { flush(); }
+
+        void flush()
+        {
+            if (length_ > 0 && sink_.write != NULL) sink_.write(sink_.context, buffer_, length_);
+            length_ = 0;
+        }
+
+        Writer &write( const char *data, size_t length )
+        {
+            while (length > 0)
+            {
+                if (length_ == sizeof(buffer_)) flush();
+                size_t count = sizeof(buffer_) - length_;
+                if (count > length) count = length;
+                memcpy(buffer_ + length_, data, count);
+                length_ += count;
+                data += count;
+                length -= count;
+            }
+            return *this;
+        }
+
+        Writer &operator<<( char value )
+        {
+            if (length_ == sizeof(buffer_)) flush();
+            buffer_[length_++] = value;
+            return *this;
+        }
+
+        Writer &operator<<( const char *value ) { return write(value, strlen(value)); }
+        Writer &operator<<( std::string_view value ) { return write(value.data(), value.size()); }
+
+        // unprintable bytes are written as '.' (see 'SanitizedString')
+        Writer &operator<<( const SanitizedString &value )
+        {
+            if ((value.flags & (STRING_CONTROL | STRING_NON_ASCII)) == 0) return write(value.data, value.length);
+
+            const char *ptr = value.data;
+            size_t length = value.length;
+            while (length > 0)
+            {
+                size_t pos = findUnprintable(ptr, length);
+                write(ptr, pos);
+                if (pos == length) break;
+                *this << '.';
+                ptr += pos + 1;
+                length -= pos + 1;
+            }
+            return *this;
+        }
+
+        Writer &operator<<( unsigned long long value )
+        {
+            char digits[20];
+            int count = 0;
+            do
+            {
+                digits[sizeof(digits) - ++count] = (char) ('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            return write(digits + sizeof(digits) - count, (size_t) count);
+        }
+
+        Writer &operator<<( long long value )
+        {
+            if (value >= 0) return *this << (unsigned long long) value;
+            return *this << '-' << (unsigned long long) -(value + 1) + 1;
+        }
+
+        Writer &operator<<( int value ) { return *this << (long long) value; }
+        Writer &operator<<( unsigned value ) { return *this << (unsigned long long) value; }
+        Writer &operator<<( unsigned long value ) { return *this << (unsigned long long) value; }
+
+        Writer &operator<<( const Hex &value )
+        {
+            static const char DIGITS[] = "0123456789abcdef";
+            char digits[16];
+            int count = 0;
+            uint64_t current = value.value;
+            do
+            {
+                digits[sizeof(digits) - ++count] = DIGITS[current & 0x0F];
+                current >>= 4;
+            } while (current != 0);
+            for (int i = count; i < value.width; ++i) *this << '0';
+            return write(digits + sizeof(digits) - count, (size_t) count);
+        }
+
+    private:
+        const ByteSink &sink_;
+        char buffer_[512];
+        size_t length_;
+};
+
+// prints the name of an enumerated value, or the raw number if it has no name
+void printName( Writer &out, std::string_view name, int value )
+{
+    if (name.empty())
+        out << value;
+    else
+        out << name;
+}
+
+// prints the names of the bits set in 'flags' as a comma separated list
+void printFlags( Writer &out, uint64_t flags, int bits, std::string_view (*name)( int bit ) )
+{
+    bool first = true;
+    for (int i = 0; i < bits; ++i)
+    {
+        if ((flags & (1ULL << i)) == 0 || name(i).empty()) continue;
+        if (!first) out << ", ";
+        out << name(i);
+        first = false;
+    }
+}
+
+/*
+ * Prints a string field as "<key>:<value>". A value that had to be altered to
+ * be printable (control or non-ASCII bytes shown as '.') is followed by a
+ * "<key>_invalid:" line naming what was found, so consumers can tell it from
+ * a value that really contains dots.
+ */
+void printInvalid( Writer &out, const char *key, int flags )
+{
+    if ((flags & (STRING_CONTROL | STRING_NON_ASCII)) == 0) return;
+    out << key << "_invalid:";
+    if (flags & STRING_CONTROL) out << "control";
+    if ((flags & STRING_CONTROL) && (flags & STRING_NON_ASCII)) out << ", ";
+    if (flags & STRING_NON_ASCII) out << "non_ascii";
+    out << '\n';
+}
+
+void printString( Writer &out, const char *key, const char *value )
+{
+    SanitizedString str = sanitizeString(value);
+    out << key << ':' << str << '\n';
+    printInvalid(out, key, str.flags);
+}
+
+void writeBuffer( void *context, const char *data, size_t size )
+{
+    BufferSink &buffer = *(BufferSink*) context;
+    if (buffer.length < buffer.capacity)
+    {
+        size_t count = buffer.capacity - buffer.length;
+        if (count > size) count = size;
+        memcpy(buffer.data + buffer.length, data, count);
+    }
+    buffer.length += size;
+}
+
+}
+
+ByteSink makeBufferSink( BufferSink &buffer )
+{
+    buffer.length = 0;
+    ByteSink sink = { writeBuffer, &buffer };
+    return sink;
+}
+
+bool emitSMBIOS( Parser &parser, const ByteSink &sink )
+{
+    Writer out(sink);
+    int version = parser.version();
+    const Entry *entry = NULL;
+    while (true)
+    {
+        entry = parser.next();
+        if (entry == NULL) break;
+        out << "Handle 0x" << Hex(entry->handle, 4)
+            << ", DMI Type " << (int) entry->type << ", " << (int) entry->length << " bytes\n";
+
+        if (entry->type == DMI_TYPE_BIOS)
+        {
+            if (version >= SMBIOS_2_0)
+            {
+                printString(out, "[bios] vendor", entry->data.bios.Vendor);
+                printString(out, "[bios] version", entry->data.bios.BIOSVersion);
+                out << "[bios] starting_segment:" << Hex(entry->data.bios.BIOSStartingSegment) << '\n';
+                printString(out, "[bios] release_date", entry->data.bios.BIOSReleaseDate);
+                out << "[bios] rom_size:" << (((int) entry->data.bios.BIOSROMSize + 1) * 64) << " KiB \n";
+                uint64_t characteristics = 0;
+                for (size_t i = 0; i < 8; ++i)
+                    characteristics |= (uint64_t) entry->data.bios.BIOSCharacteristics[i] << (i * 8);
+                out << "[bios] characteristics:";
+                // bit 3 means no other bit is meaningful
+                if (characteristics & (1ULL << 3))
+                    out << biosCharacteristicName(3);
+                else
+                    printFlags(out, characteristics, 32, biosCharacteristicName);
+                out << '\n';
+            }
+            if (version >= SMBIOS_2_4)
+            {
+                out << "[bios] characteristics_ext1:";
+                printFlags(out, entry->data.bios.ExtensionByte1, 8, biosCharacteristicExt1Name);
+                out << '\n';
+                out << "[bios] characteristics_ext2:";
+                printFlags(out, entry->data.bios.ExtensionByte2, 8, biosCharacteristicExt2Name);
+                out << '\n';
+                out << "[bios] system_bios_major_release:" << (int) entry->data.bios.SystemBIOSMajorRelease  << '\n';
+                out << "[bios] system_bios_minor_release:" << (int) entry->data.bios.SystemBIOSMinorRelease  << '\n';
+                out << "[bios] embedded_firmware_major_release:" << (int) entry->data.bios.EmbeddedFirmwareMajorRelease  << '\n';
+                out << "[bios] embedded_firmware_minor_release:" << (int) entry->data.bios.EmbeddedFirmwareMinorRelease  << '\n';
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_SYSINFO)
+        {
+            if (version >= SMBIOS_2_0)
+            {
+                printString(out, "[sysinfo] manufacturer", entry->data.sysinfo.Manufacturer);
+                printString(out, "[sysinfo] product_name", entry->data.sysinfo.ProductName);
+                printString(out, "[sysinfo] version", entry->data.sysinfo.Version);
+                printString(out, "[sysinfo] serial_number", entry->data.sysinfo.SerialNumber);
+            }
+            if (version >= SMBIOS_2_1)
+            {
+                out << "[sysinfo] uuid:";
+                for (size_t i = 0; i < 16; ++i)
+                    out << Hex(entry->data.sysinfo.UUID[i], 2) << ' ';
+                out << '\n';
+            }
+            if (version >= SMBIOS_2_4)
+            {
+                printString(out, "[sysinfo] sku_number", entry->data.sysinfo.SKUNumber);
+                printString(out, "[sysinfo] family", entry->data.sysinfo.Family);
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_BASEBOARD)
+        {
+            if (version >= SMBIOS_2_0)
+            {
+                printString(out, "[baseboard] manufacturer", entry->data.baseboard.Manufacturer);
+                printString(out, "[baseboard] product", entry->data.baseboard.Product);
+                printString(out, "[baseboard] version", entry->data.baseboard.Version);
+                printString(out, "[baseboard] serial_number", entry->data.baseboard.SerialNumber);
+                printString(out, "[baseboard] asset_tag", entry->data.baseboard.AssetTag);
+                printString(out, "[baseboard] location_in_chassis", entry->data.baseboard.LocationInChassis);
+                out << "[baseboard] chassis_handle:" << entry->data.baseboard.ChassisHandle << '\n';
+                out << "[baseboard] board_type:";
+                printName(out, boardTypeName(entry->data.baseboard.BoardType), entry->data.baseboard.BoardType);
+                out << '\n';
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_SYSENCLOSURE)
+        {
+            if (version >= SMBIOS_2_0)
+            {
+                printString(out, "[sysenclosure] manufacturer", entry->data.sysenclosure.Manufacturer);
+                out << "[sysenclosure] type:";
+                printName(out, chassisTypeName(entry->data.sysenclosure.Type), entry->data.sysenclosure.Type & 0x7F);
+                out << '\n';
+                printString(out, "[sysenclosure] version", entry->data.sysenclosure.Version);
+                printString(out, "[sysenclosure] serial_number", entry->data.sysenclosure.SerialNumber);
+                printString(out, "[sysenclosure] asset_tag", entry->data.sysenclosure.AssetTag);
+            }
+            if (version >= SMBIOS_2_3)
+            {
+                out << "[sysenclosure] contained_count:" << (int) entry->data.sysenclosure.ContainedElementCount << '\n';
+                out << "[sysenclosure] contained_length:" << (int) entry->data.sysenclosure.ContainedElementRecordLength << '\n';
+            }
+            if (version >= SMBIOS_2_7)
+            {
+                printString(out, "[sysenclosure] sku_number", entry->data.sysenclosure.SKUNumber);
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_PROCESSOR)
+        {
+            if (version >= SMBIOS_2_0)
+            {
+                printString(out, "[processor] socket_designation", entry->data.processor.SocketDesignation);
+                // 0xFE means the family is only available in 'ProcessorFamily2'
+                int family = entry->data.processor.ProcessorFamily;
+                if (family == 0xFE && version >= SMBIOS_2_6)
+                    family = entry->data.processor.ProcessorFamily2;
+                out << "[processor] processor_family:";
+                printName(out, processorFamilyName((uint16_t) family), family);
+                out << '\n';
+                printString(out, "[processor] manufacturer", entry->data.processor.ProcessorManufacturer);
+                printString(out, "[processor] version", entry->data.processor.ProcessorVersion);
+                out << "[processor] processor_id:";
+                for (size_t i = 0; i < 8; ++i)
+                    out << Hex(entry->data.processor.ProcessorID[i], 2) << ' ';
+                out << '\n';
+            }
+            if (version >= SMBIOS_2_5)
+            {
+                out << "[processor] core_count:" << (int) entry->data.processor.CoreCount << '\n';
+                out << "[processor] core_enabled:" << (int) entry->data.processor.CoreEnabled << '\n';
+                out << "[processor] thread_count:" << (int) entry->data.processor.ThreadCount << '\n';
+            }
+            if (version >= SMBIOS_2_6)
+            {
+                out << "[processor] processor_family_2:";
+                printName(out, processorFamilyName(entry->data.processor.ProcessorFamily2), entry->data.processor.ProcessorFamily2);
+                out << '\n';
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_CACHE)
+        {
+            if (version >= SMBIOS_2_0)
+            {
+                printString(out, "[cache] socket_designation", entry->data.cache.SocketDesignation);
+                out << "[cache] level:" << ((entry->data.cache.CacheConfiguration & 0x07) + 1) << '\n';
+                out << "[cache] installed_size:" << cacheInstalledSize(entry->data.cache) << " KiB\n";
+            }
+            if (version >= SMBIOS_2_1)
+            {
+                out << "[cache] system_type:";
+                printName(out, cacheTypeName(entry->data.cache.SystemCacheType), entry->data.cache.SystemCacheType);
+                out << '\n';
+                out << "[cache] associativity:";
+                printName(out, cacheAssociativityName(entry->data.cache.Associativity), entry->data.cache.Associativity);
+                out << '\n';
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_SYSSLOT)
+        {
+            if (version >= SMBIOS_2_0)
+            {
+                printString(out, "[sysslot] slot_designation", entry->data.sysslot.SlotDesignation);
+                out << "[sysslot] slot_type:";
+                printName(out, slotTypeName(entry->data.sysslot.SlotType), entry->data.sysslot.SlotType);
+                out << '\n';
+                out << "[sysslot] slot_data_bus_width:";
+                printName(out, slotDataBusWidthName(entry->data.sysslot.SlotDataBusWidth), entry->data.sysslot.SlotDataBusWidth);
+                out << '\n';
+                out << "[sysslot] slot_id:" << (int) entry->data.sysslot.SlotID << '\n';
+            }
+            if (version >= SMBIOS_2_6)
+            {
+                out << "[sysslot] segment_group_number:" << entry->data.sysslot.SegmentGroupNumber << '\n';
+                out << "[sysslot] bus_number:" << (int) entry->data.sysslot.BusNumber << '\n';
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_PHYSMEM)
+        {
+            if (version >= SMBIOS_2_1)
+            {
+                out << "[physmem] use:" << Hex(entry->data.physmem.Use) << '\n';
+                out << "[physmem] number_devices:" << entry->data.physmem.NumberDevices << '\n';
+                out << "[physmem] maximum_capacity:" << entry->data.physmem.MaximumCapacity << " KiB\n";
+                out << "[physmem] ext_maximum_capacity:" << entry->data.physmem.ExtendedMaximumCapacity << " KiB\n";
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_MEMORY)
+        {
+            if (version >= SMBIOS_2_1)
+            {
+                printString(out, "[memory] device_locator", entry->data.memory.DeviceLocator);
+                printString(out, "[memory] bank_locator", entry->data.memory.BankLocator);
+                out << "[memory] form_factor:";
+                printName(out, memoryFormFactorName(entry->data.memory.FormFactor), entry->data.memory.FormFactor);
+                out << '\n';
+                out << "[memory] type:";
+                printName(out, memoryTypeName(entry->data.memory.MemoryType), entry->data.memory.MemoryType);
+                out << '\n';
+            }
+            if (version >= SMBIOS_2_3)
+            {
+                out << "[memory] speed:" << entry->data.memory.Speed << " MHz\n";
+                printString(out, "[memory] manufacturer", entry->data.memory.Manufacturer);
+                printString(out, "[memory] serial_number", entry->data.memory.SerialNumber);
+                printString(out, "[memory] asset_tag_number", entry->data.memory.AssetTagNumber);
+                printString(out, "[memory] part_number", entry->data.memory.PartNumber);
+                out << "[memory] size:" << entry->data.memory.Size << " MiB\n";
+                out << "[memory] extended_size:" << entry->data.memory.ExtendedSize << " MiB\n";
+            }
+            if (version >= SMBIOS_2_7)
+            {
+                out << "[memory] configured_clock_speed:" << entry->data.memory.ConfiguredClockSpeed << " MHz\n";
+            }
+            out << '\n';
+        }
+        else
+        if (entry->type == DMI_TYPE_OEMSTRINGS)
+        {
+            if (version >= SMBIOS_2_0)
+            {
+                out << "[oemstrings] count:" << (int) entry->data.oemstrings.Count << '\n';
+                const char *ptr = entry->data.oemstrings.Values;
+                int c = entry->data.oemstrings.Count;
+				out << "[oemstrings] values:";
+				int i = 0;
+				int flags = 0;
+                while (ptr != nullptr && *ptr != 0 && c > 0)
+                {
+					SanitizedString str = sanitizeString(ptr);
+					flags |= str.flags;
+					if (i) {
+						out << ", " << str;
+					} else {
+						out << str;
+					}
+
+                    while (*ptr != 0) ++ptr;
+
+                    ++ptr;
+					++i;
+                }
+
+				out << '\n';
+				printInvalid(out, "[oemstrings] values", flags);
+            }
+            out << '\n';
+        }
+
+    }
+
+    return true;
+}
+
+#ifdef _WIN32
+
+size_t readDMI( uint8_t *buffer, size_t size )
+{
+    const BYTE byteSignature[] = { 'B', 'M', 'S', 'R' };
+    const DWORD signature = *((DWORD*)byteSignature);
+
+    // get the size of SMBIOS table
+    DWORD required = GetSystemFirmwareTable(signature, 0, NULL, 0);
+    if (required == 0 || required > size) return 0;
+    // retrieve the SMBIOS table
+    if (required != GetSystemFirmwareTable(signature, 0, buffer, required)) return 0;
+    return required;
+}
+
+#else
+
+// reads up to 'size' bytes of 'path/name'; returns the file size or -1 on error
+static long readFile( const char *path, const char *name, uint8_t *buffer, size_t size )
+{
+    char fileName[512];
+    size_t pathLength = strlen(path);
+    size_t nameLength = strlen(name);
+    if (pathLength + nameLength + 2 > sizeof(fileName)) return -1;
+    memcpy(fileName, path, pathLength);
+    fileName[pathLength] = '/';
+    memcpy(fileName + pathLength + 1, name, nameLength + 1);
+
+    int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    size_t total = 0;
+    while (total < size)
+    {
+        ssize_t count = read(fd, buffer + total, size - total);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+        total += (size_t) count;
+    }
+    close(fd);
+    return (long) info.st_size;
+}
+
+size_t readDMI( const char *path, uint8_t *buffer, size_t size )
+{
+    const size_t ENTRY_POINT_SIZE = 32;
+    if (path == NULL || buffer == NULL || size < ENTRY_POINT_SIZE) return 0;
+
+    // read SMBIOS structures (same layout as 'getDMI': entry point first)
+    long length = readFile(path, "DMI", buffer + ENTRY_POINT_SIZE, size - ENTRY_POINT_SIZE);
+    if (length < 0 || (size_t) length > size - ENTRY_POINT_SIZE) return 0;
+
+    // read SMBIOS entry point (the 2.x one is only 31 bytes long)
+    memset(buffer, 0, ENTRY_POINT_SIZE);
+    if (readFile(path, "smbios_entry_point", buffer, ENTRY_POINT_SIZE) < 0) return 0;
+
+    return ENTRY_POINT_SIZE + (size_t) length;
+}
+
+#endif
+
+} // namespace smbios
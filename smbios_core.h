@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SMBIOS_CORE_HH
+#define SMBIOS_CORE_HH
+
+#include <stddef.h>
+#include <stdint.h>
+#include "smbios.h"
+
+/*
+ * Allocation-free reader and text emitter for constrained collectors
+ * (initramfs, rescue shells). Everything works on caller-provided buffers:
+ * no heap, no exceptions, no RTTI and no iostreams. The core build is
+ *
+ *   smbios.cpp smbios_strings.cpp smbios_core.cpp
+ *
+ * compiled with SMBIOS_CORE and without exceptions or RTTI; MalwareCollector.pro
+ * (and MalwareCollector.vcxproj) build the 'smbios-collect' tool that way. The
+ * text is the same 'printSMBIOS' produces (which is built on top of this emitter).
+ */
+
+namespace smbios {
+
+// Receives the emitted text in pieces (not NUL terminated)
+struct ByteSink
+{
+    void (*write)( void *context, const char *data, size_t size );
+    void *context;
+};
+
+// Sink over a fixed buffer: keeps what fits and still counts the rest
+struct BufferSink
+{
+    char *data;
+    size_t capacity;
+    size_t length;  // bytes emitted so far; above 'capacity' means truncated output
+};
+
+ByteSink makeBufferSink( BufferSink &buffer );
+
+bool emitSMBIOS( Parser &parser, const ByteSink &sink );
+
+#ifdef _WIN32
+// Same as 'getDMI', into 'buffer'. Returns the number of bytes used (0 on error or if it does not fit)
+size_t readDMI( uint8_t *buffer, size_t size );
+#else
+// Same as 'getDMI', into 'buffer'. Returns the number of bytes used (0 on error or if it does not fit)
+size_t readDMI( const char *path, uint8_t *buffer, size_t size );
+#endif
+
+} // namespace smbios
+
+#endif // SMBIOS_CORE_HH
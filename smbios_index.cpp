@@ -0,0 +1,484 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "smbios_index.h"
+#include "smbios_strings.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define INDEX_MAGIC    "SMBIDX\0\0"
+#define INDEX_VERSION  1
+
+namespace smbios {
+
+namespace {
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t tables;
+    uint32_t terms;
+    uint32_t reserved;
+    uint64_t termsOffset;
+    uint64_t keysOffset;
+    uint64_t postingsOffset;
+    uint64_t namesOffset;
+    uint64_t nameOffsetsOffset;
+};
+
+struct FileTerm
+{
+    uint64_t key;        // relative to 'keysOffset'
+    uint64_t postings;   // relative to 'postingsOffset'
+    uint32_t keyLength;
+    uint32_t count;
+    uint32_t postingsLength;
+    uint32_t reserved;
+};
+
+// Offsets of the string references in the formatted area of each structure type
+struct StringFields
+{
+    uint8_t type;
+    uint8_t count;
+    uint8_t offsets[8];
+};
+
+const StringFields STRING_FIELDS[] =
+{
+    { DMI_TYPE_BIOS,         3, { 0x04, 0x05, 0x08 } },
+    { DMI_TYPE_SYSINFO,      6, { 0x04, 0x05, 0x06, 0x07, 0x19, 0x1A } },
+    { DMI_TYPE_BASEBOARD,    6, { 0x04, 0x05, 0x06, 0x07, 0x08, 0x0A } },
+    { DMI_TYPE_SYSENCLOSURE, 4, { 0x04, 0x06, 0x07, 0x08 } },
+    { DMI_TYPE_PROCESSOR,    6, { 0x04, 0x07, 0x10, 0x20, 0x21, 0x22 } },
+    { DMI_TYPE_CACHE,        1, { 0x04 } },
+    { DMI_TYPE_SYSSLOT,      1, { 0x04 } },
+    { DMI_TYPE_MEMORY,       6, { 0x10, 0x11, 0x17, 0x18, 0x19, 0x1A } },
+};
+
+std::string makeKey( uint8_t type, uint8_t field, const char *value, size_t length )
+{
+    std::string key;
+    key.reserve(2 + length);
+    key.push_back((char) type);
+    key.push_back((char) field);
+    key.append(value, length);
+    return key;
+}
+
+void putVarint( std::string &output, uint32_t value )
+{
+    while (value >= 0x80)
+    {
+        output.push_back((char) (value | 0x80));
+        value >>= 7;
+    }
+    output.push_back((char) value);
+}
+
+// true if [offset, offset + length) lies within 'size' bytes (without overflowing)
+bool fits( uint64_t offset, uint64_t length, uint64_t size )
+{
+    return offset <= size && length <= size - offset;
+}
+
+void align( std::ofstream &output, uint64_t &offset )
+{
+    static const char ZEROS[8] = { 0 };
+    size_t padding = (size_t) ((8 - offset % 8) % 8);
+    output.write(ZEROS, (std::streamsize) padding);
+    offset += padding;
+}
+
+}
+
+IndexBuilder::IndexBuilder()
+{
+}
+
+size_t IndexBuilder::terms() const
+{
+    return terms_.size();
+}
+
+void IndexBuilder::addTerm( uint8_t type, uint8_t field, const char *value, uint32_t id )
+{
+    SanitizedString str = sanitizeString(value);
+    if (str.length == 0) return;
+
+    std::string key = makeKey(type, field, str.data, str.length);
+    std::unordered_map<std::string, uint32_t>::iterator it = terms_.find(key);
+    if (it == terms_.end())
+    {
+        it = terms_.insert(std::make_pair(key, (uint32_t) postings_.size())).first;
+        postings_.push_back(std::vector<uint32_t>());
+    }
+    // IDs only grow, so a repeated term in the same table is always the last one
+    std::vector<uint32_t> &ids = postings_[it->second];
+    if (ids.empty() || ids.back() != id) ids.push_back(id);
+}
+
+uint32_t IndexBuilder::addTable( const std::string &name, const Parser &parser )
+{
+    uint32_t id = (uint32_t) names_.size();
+    names_.push_back(name);
+
+    Structures range = structures(parser);
+    for (StructureIterator it = range.begin(); it != range.end(); ++it)
+    {
+        const Structure &entry = *it;
+        const uint8_t *data = entry.data();
+
+        if (entry.type() == DMI_TYPE_OEMSTRINGS)
+        {
+            if (entry.length() <= 0x04) continue;
+            for (int i = 1; i <= data[0x04]; ++i)
+                addTerm(DMI_TYPE_OEMSTRINGS, 0x04, entry.string(i), id);
+            continue;
+        }
+
+        for (size_t i = 0; i < sizeof(STRING_FIELDS) / sizeof(STRING_FIELDS[0]); ++i)
+        {
+            const StringFields &fields = STRING_FIELDS[i];
+            if (fields.type != entry.type()) continue;
+            for (int j = 0; j < fields.count; ++j)
+            {
+                uint8_t offset = fields.offsets[j];
+                if (offset < entry.length())
+                    addTerm(fields.type, offset, entry.string(data[offset]), id);
+            }
+            // the enclosure SKU comes after the variable-size contained elements
+            if (fields.type == DMI_TYPE_SYSENCLOSURE && entry.length() > 0x14)
+            {
+                size_t offset = 0x15 + (size_t) data[0x13] * data[0x14];
+                if (offset < entry.length())
+                    addTerm(fields.type, 0x15, entry.string(data[offset]), id);
+            }
+            break;
+        }
+    }
+
+    return id;
+}
+
+bool IndexBuilder::write( const std::string &path ) const
+{
+    // the term directory is sorted by key so queries can binary search it
+    std::vector< std::pair<const std::string*, uint32_t> > sorted;
+    sorted.reserve(terms_.size());
+    for (std::unordered_map<std::string, uint32_t>::const_iterator it = terms_.begin(); it != terms_.end(); ++it)
+        sorted.push_back(std::make_pair(&it->first, it->second));
+    std::sort(sorted.begin(), sorted.end(),
+        []( const std::pair<const std::string*, uint32_t> &a, const std::pair<const std::string*, uint32_t> &b )
+        { return *a.first < *b.first; });
+
+    std::vector<FileTerm> directory(sorted.size());
+    std::string keys, postings, encoded;
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        const std::vector<uint32_t> &ids = postings_[sorted[i].second];
+        encoded.clear();
+        uint32_t last = 0;
+        for (size_t j = 0; j < ids.size(); ++j)
+        {
+            putVarint(encoded, ids[j] - last);
+            last = ids[j];
+        }
+
+        FileTerm &term = directory[i];
+        memset(&term, 0, sizeof(term));
+        term.key = keys.size();
+        term.keyLength = (uint32_t) sorted[i].first->size();
+        term.postings = postings.size();
+        term.postingsLength = (uint32_t) encoded.size();
+        term.count = (uint32_t) ids.size();
+        keys += *sorted[i].first;
+        postings += encoded;
+    }
+
+    std::ofstream output(path.c_str(), std::ios_base::binary | std::ios_base::trunc);
+    if (!output.good()) return false;
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.tables = (uint32_t) names_.size();
+    header.terms = (uint32_t) directory.size();
+    output.write((const char*) &header, sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    header.termsOffset = offset;
+    output.write((const char*) directory.data(), (std::streamsize) (directory.size() * sizeof(FileTerm)));
+    offset += directory.size() * sizeof(FileTerm);
+
+    header.keysOffset = offset;
+    output.write(keys.data(), (std::streamsize) keys.size());
+    offset += keys.size();
+    align(output, offset);
+
+    header.postingsOffset = offset;
+    output.write(postings.data(), (std::streamsize) postings.size());
+    offset += postings.size();
+    align(output, offset);
+
+    header.namesOffset = offset;
+    std::vector<uint64_t> nameOffsets(names_.size() + 1, 0);
+    for (size_t i = 0; i < names_.size(); ++i)
+    {
+        output.write(names_[i].data(), (std::streamsize) names_[i].size());
+        nameOffsets[i + 1] = nameOffsets[i] + names_[i].size();
+    }
+    offset += nameOffsets.back();
+    align(output, offset);
+
+    header.nameOffsetsOffset = offset;
+    output.write((const char*) nameOffsets.data(), (std::streamsize) (nameOffsets.size() * sizeof(uint64_t)));
+
+    // now that the offsets are known, rewrite the header
+    output.seekp(0);
+    output.write((const char*) &header, sizeof(header));
+    return output.good();
+}
+
+Index::Index() : data_(NULL), size_(0), mapping_(NULL)
+{
+}
+
+Index::~Index()
+{
+    close();
+}
+
+void Index::close()
+{
+    if (mapping_ != NULL) munmap(mapping_, size_);
+    mapping_ = NULL;
+    data_ = NULL;
+    size_ = 0;
+}
+
+bool Index::open( const std::string &path )
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void *mapping = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    if (!attach((const uint8_t*) mapping, (size_t) info.st_size))
+    {
+        munmap(mapping, (size_t) info.st_size);
+        return false;
+    }
+    mapping_ = mapping;
+    return true;
+}
+
+bool Index::attach( const uint8_t *data, size_t size )
+{
+    close();
+    FileHeader header;
+    if (data == NULL || size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 || header.version != INDEX_VERSION) return false;
+    // the sections follow each other in this order; the term, key and name extents are checked against them
+    uint64_t termsEnd = header.termsOffset + (uint64_t) header.terms * sizeof(FileTerm);
+    if (header.termsOffset < sizeof(header) ||
+        !fits(header.termsOffset, (uint64_t) header.terms * sizeof(FileTerm), size) ||
+        header.keysOffset < termsEnd || header.postingsOffset < header.keysOffset ||
+        header.namesOffset < header.postingsOffset || header.nameOffsetsOffset < header.namesOffset ||
+        !fits(header.nameOffsetsOffset, ((uint64_t) header.tables + 1) * sizeof(uint64_t), size)) return false;
+
+    data_ = data;
+    size_ = size;
+    return true;
+}
+
+uint32_t Index::tables() const
+{
+    if (data_ == NULL) return 0;
+    FileHeader header;
+    memcpy(&header, data_, sizeof(header));
+    return header.tables;
+}
+
+uint32_t Index::terms() const
+{
+    if (data_ == NULL) return 0;
+    FileHeader header;
+    memcpy(&header, data_, sizeof(header));
+    return header.terms;
+}
+
+std::string Index::name( uint32_t id ) const
+{
+    if (data_ == NULL) return std::string();
+    FileHeader header;
+    memcpy(&header, data_, sizeof(header));
+    if (id >= header.tables) return std::string();
+
+    uint64_t range[2];
+    memcpy(range, data_ + header.nameOffsetsOffset + id * sizeof(uint64_t), sizeof(range));
+    if (range[1] < range[0] || !fits(range[0], range[1] - range[0], header.nameOffsetsOffset - header.namesOffset))
+        return std::string();
+    return std::string((const char*) data_ + header.namesOffset + range[0], (size_t) (range[1] - range[0]));
+}
+
+bool Index::termKey( size_t index, const uint8_t *&key, size_t &length ) const
+{
+    FileHeader header;
+    FileTerm term;
+    memcpy(&header, data_, sizeof(header));
+    memcpy(&term, data_ + header.termsOffset + index * sizeof(FileTerm), sizeof(term));
+    if (!fits(term.key, term.keyLength, header.postingsOffset - header.keysOffset)) return false;
+    key = data_ + header.keysOffset + term.key;
+    length = term.keyLength;
+    return true;
+}
+
+size_t Index::lowerBound( const std::string &key ) const
+{
+    size_t first = 0, count = terms();
+    while (count > 0)
+    {
+        size_t step = count / 2;
+        size_t middle = first + step;
+        const uint8_t *current;
+        size_t length;
+        if (!termKey(middle, current, length)) return terms();
+
+        int cmp = memcmp(current, key.data(), std::min(length, key.size()));
+        if (cmp < 0 || (cmp == 0 && length < key.size()))
+        {
+            first = middle + 1;
+            count -= step + 1;
+        }
+        else
+            count = step;
+    }
+    return first;
+}
+
+void Index::decode( size_t index, std::vector<uint32_t> &ids ) const
+{
+    FileHeader header;
+    FileTerm term;
+    memcpy(&header, data_, sizeof(header));
+    memcpy(&term, data_ + header.termsOffset + index * sizeof(FileTerm), sizeof(term));
+    if (!fits(term.postings, term.postingsLength, header.namesOffset - header.postingsOffset)) return;
+
+    const uint8_t *ptr = data_ + header.postingsOffset + term.postings;
+    const uint8_t *end = ptr + term.postingsLength;
+    // only when empty: an exact reserve per call would defeat geometric growth when appending
+    // (every ID takes at least a byte, which bounds a corrupt count)
+    if (ids.empty()) ids.reserve(std::min(term.count, term.postingsLength));
+    uint32_t last = 0;
+    while (ptr < end)
+    {
+        uint32_t delta = 0;
+        for (int shift = 0; ptr < end && shift < 35; shift += 7)
+        {
+            uint8_t byte = *ptr++;
+            delta |= (uint32_t) (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) break;
+        }
+        last += delta;
+        ids.push_back(last);
+    }
+}
+
+std::vector<uint32_t> Index::find( const IndexTerm &term ) const
+{
+    std::vector<uint32_t> ids;
+    if (data_ == NULL) return ids;
+
+    // values are indexed sanitized, so the query must be too (see 'addTerm')
+    SanitizedString value = sanitizeString(term.value.c_str(), term.value.size());
+    if (value.length == 0 && !term.prefix) return ids;
+    std::string key = makeKey(term.type, term.field, value.data, value.length);
+    size_t count = terms(), matches = 0;
+    for (size_t i = lowerBound(key); i < count; ++i)
+    {
+        const uint8_t *current;
+        size_t length;
+        if (!termKey(i, current, length)) break;
+        if (length < key.size() || memcmp(current, key.data(), key.size()) != 0) break;
+        if (!term.prefix && length != key.size()) break;
+
+        decode(i, ids);
+        if (!term.prefix) return ids;
+        ++matches;
+    }
+    // a prefix may match many terms: merging them one by one would be quadratic
+    if (matches > 1)
+    {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+    return ids;
+}
+
+std::vector<uint32_t> Index::findAll( const std::vector<IndexTerm> &terms ) const
+{
+    std::vector<uint32_t> ids;
+    for (size_t i = 0; i < terms.size(); ++i)
+    {
+        std::vector<uint32_t> current = find(terms[i]);
+        ids = (i == 0) ? current : intersectIds(ids, current);
+        if (ids.empty()) break;
+    }
+    return ids;
+}
+
+std::vector<uint32_t> Index::findAny( const std::vector<IndexTerm> &terms ) const
+{
+    std::vector<uint32_t> ids;
+    for (size_t i = 0; i < terms.size(); ++i)
+        ids = uniteIds(ids, find(terms[i]));
+    return ids;
+}
+
+std::vector<uint32_t> intersectIds( const std::vector<uint32_t> &a, const std::vector<uint32_t> &b )
+{
+    std::vector<uint32_t> result;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+std::vector<uint32_t> uniteIds( const std::vector<uint32_t> &a, const std::vector<uint32_t> &b )
+{
+    std::vector<uint32_t> result;
+    result.reserve(a.size() + b.size());
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+} // namespace smbios
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SMBIOS_INDEX_HH
+#define SMBIOS_INDEX_HH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smbios.h"
+
+/*
+ * Inverted index over a corpus of SMBIOS tables.
+ *
+ * Every string field of every structure becomes a term (type, field, value),
+ * where 'field' is the offset of the string reference inside the formatted
+ * area as given by the SMBIOS specification (e.g. type 17, field 0x1A is the
+ * memory device part number). Values are indexed trimmed (see
+ * 'sanitizeString'). Each term maps to the sorted list of the table IDs that
+ * contain it, stored delta + varint encoded.
+ *
+ * The index file is laid out so it can be mapped and queried in place:
+ *
+ *   header | term directory (sorted by key) | keys | postings | names | name offsets
+ */
+
+namespace smbios {
+
+struct IndexTerm
+{
+    uint8_t type;
+    uint8_t field;
+    std::string value;  // trimmed like the indexed values before the lookup
+    bool prefix;  // match every value starting with 'value'
+};
+
+class IndexBuilder
+{
+    public:
+        IndexBuilder();
+
+        // Indexes every string of the table and returns its ID (IDs are sequential from 0)
+        uint32_t addTable( const std::string &name, const Parser &parser );
+        bool write( const std::string &path ) const;
+        size_t terms() const;
+
+    private:
+        std::unordered_map<std::string, uint32_t> terms_;
+        std::vector< std::vector<uint32_t> > postings_;
+        std::vector<std::string> names_;
+
+        void addTerm( uint8_t type, uint8_t field, const char *value, uint32_t id );
+};
+
+class Index
+{
+    public:
+        Index();
+        ~Index();
+
+        // Maps an index file (read-only)
+        bool open( const std::string &path );
+        // Uses an index already in memory; the buffer must outlive the index
+        bool attach( const uint8_t *data, size_t size );
+        void close();
+
+        uint32_t tables() const;
+        uint32_t terms() const;
+        std::string name( uint32_t id ) const;
+
+        // Table IDs matching a single term (sorted)
+        std::vector<uint32_t> find( const IndexTerm &term ) const;
+        // Table IDs matching every term (AND) or any term (OR)
+        std::vector<uint32_t> findAll( const std::vector<IndexTerm> &terms ) const;
+        std::vector<uint32_t> findAny( const std::vector<IndexTerm> &terms ) const;
+
+    private:
+        const uint8_t *data_;
+        size_t size_;
+        void *mapping_;
+
+        Index( const Index& );
+        Index &operator=( const Index& );
+
+        size_t lowerBound( const std::string &key ) const;
+        bool termKey( size_t index, const uint8_t *&key, size_t &length ) const;
+        void decode( size_t index, std::vector<uint32_t> &ids ) const;
+};
+
+std::vector<uint32_t> intersectIds( const std::vector<uint32_t> &a, const std::vector<uint32_t> &b );
+std::vector<uint32_t> uniteIds( const std::vector<uint32_t> &a, const std::vector<uint32_t> &b );
+
+} // namespace smbios
+
+#endif // SMBIOS_INDEX_HH
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "smbios_stream.h"
+#include <cstring>
+
+#define DMI_ENTRY_HEADER_SIZE   4
+
+namespace smbios {
+
+enum StreamState
+{
+    STREAM_HEADER,
+    STREAM_TABLE,
+    STREAM_DONE,
+    STREAM_INVALID
+};
+
+// Length of the structure at 'data' if it is complete (0 if not; SIZE_MAX if malformed)
+static size_t structureLength( const uint8_t *data, size_t size )
+{
+    if (size < DMI_ENTRY_HEADER_SIZE) return 0;
+    size_t length = data[1];
+    if (length < DMI_ENTRY_HEADER_SIZE) return SIZE_MAX;
+
+    // the string set ends with a double NUL
+    for (size_t i = length; i + 1 < size; ++i)
+    {
+        const uint8_t *nul = (const uint8_t*) memchr(data + i, 0, size - 1 - i);
+        if (nul == NULL) break;
+        i = (size_t) (nul - data);
+        if (data[i + 1] == 0) return i + 2;
+    }
+    return 0;
+}
+
+StreamParser::StreamParser( const StructureHandler &handler, int version, int format, size_t maxStructure ) :
+    handler_(handler), requestedVersion_(version), requestedFormat_(format), maxStructure_(maxStructure)
+{
+    if (maxStructure_ < DMI_HEADER_PROBE_SIZE) maxStructure_ = DMI_HEADER_PROBE_SIZE;
+    reset();
+}
+
+void StreamParser::reset()
+{
+    state_ = STREAM_HEADER;
+    version_ = 0;
+    format_ = requestedFormat_;
+    // bare tables have no header to wait for, but need the version
+    if (requestedFormat_ == SMBIOS_FORMAT_TABLE)
+    {
+        state_ = (requestedVersion_ != 0) ? STREAM_TABLE : STREAM_INVALID;
+        version_ = requestedVersion_;
+    }
+    remaining_ = UINT64_MAX;
+    structures_ = 0;
+    carry_.clear();
+}
+
+bool StreamParser::valid() const
+{
+    return state_ != STREAM_INVALID;
+}
+
+bool StreamParser::done() const
+{
+    return state_ == STREAM_DONE;
+}
+
+int StreamParser::format() const
+{
+    return format_;
+}
+
+int StreamParser::version() const
+{
+    return version_;
+}
+
+size_t StreamParser::structures() const
+{
+    return structures_;
+}
+
+bool StreamParser::beginTable( bool partial )
+{
+    InputHeader header;
+    if (!smbios::readHeader(carry_.data(), carry_.size(), requestedVersion_, requestedFormat_, partial, header) ||
+        carry_.size() < header.offset || header.length < DMI_ENTRY_HEADER_SIZE)
+    {
+        state_ = STREAM_INVALID;
+        return false;
+    }
+
+    format_ = header.format;
+    version_ = header.version;
+    if (requestedVersion_ != 0 && requestedVersion_ < version_) version_ = requestedVersion_;
+    if (header.length != SIZE_MAX) remaining_ = header.length;
+    state_ = STREAM_TABLE;
+
+    // whatever followed the header is the start of the table
+    std::vector<uint8_t> table(carry_.begin() + (std::ptrdiff_t) header.offset, carry_.end());
+    carry_.clear();
+    consume(table.data(), table.size());
+    return state_ != STREAM_INVALID;
+}
+
+bool StreamParser::push( const uint8_t *data, size_t size )
+{
+    if (state_ == STREAM_HEADER)
+    {
+        size_t count = DMI_HEADER_PROBE_SIZE - carry_.size();
+        if (count > size) count = size;
+        carry_.insert(carry_.end(), data, data + count);
+        data += count;
+        size -= count;
+        if (carry_.size() < DMI_HEADER_PROBE_SIZE || !beginTable(true)) return valid();
+    }
+    consume(data, size);
+    return valid();
+}
+
+bool StreamParser::finish()
+{
+    // dumps shorter than the probe are complete by now
+    if (state_ == STREAM_HEADER && !beginTable(false)) return false;
+    if (state_ == STREAM_TABLE && !carry_.empty()) state_ = STREAM_INVALID;
+    if (state_ == STREAM_TABLE) state_ = STREAM_DONE;
+    return valid();
+}
+
+void StreamParser::consume( const uint8_t *data, size_t size )
+{
+    // bytes past a table whose header gives its length are not part of it
+    if (size > remaining_) size = (size_t) remaining_;
+    if (remaining_ != UINT64_MAX) remaining_ -= size;
+
+    while (size > 0 && state_ == STREAM_TABLE)
+    {
+        size_t count = carry_.empty() ? consumeInPlace(data, size) : consumeCarried(data, size);
+        data += count;
+        size -= count;
+    }
+    if (remaining_ == 0 && state_ == STREAM_TABLE && carry_.empty()) state_ = STREAM_DONE;
+}
+
+// Structures entirely inside the chunk are decoded where they are
+size_t StreamParser::consumeInPlace( const uint8_t *data, size_t size )
+{
+    size_t length = structureLength(data, size);
+    if (length == SIZE_MAX)
+    {
+        state_ = STREAM_INVALID;
+        return size;
+    }
+    if (length > 0)
+    {
+        emit(data, length);
+        return length;
+    }
+
+    // the structure goes on in the next chunk
+    if (size > maxStructure_)
+        state_ = STREAM_INVALID;
+    else
+        carry_.assign(data, data + size);
+    return size;
+}
+
+// Completes the carried structure with the start of the chunk
+size_t StreamParser::consumeCarried( const uint8_t *data, size_t size )
+{
+    size_t count = 0;
+    if (carry_.size() < DMI_ENTRY_HEADER_SIZE)
+        count = DMI_ENTRY_HEADER_SIZE - carry_.size();
+    else
+    {
+        size_t length = carry_[1];
+        if (length < DMI_ENTRY_HEADER_SIZE)
+        {
+            state_ = STREAM_INVALID;
+            return size;
+        }
+        if (carry_.size() < length)
+            count = length - carry_.size();
+        else
+        {
+            // the double NUL may be split by the chunk boundary
+            size_t end = 0;
+            if (carry_.size() > length && carry_.back() == 0 && data[0] == 0)
+                end = 1;
+            else
+            {
+                for (size_t i = 0; i + 1 < size; ++i)
+                {
+                    const uint8_t *nul = (const uint8_t*) memchr(data + i, 0, size - 1 - i);
+                    if (nul == NULL) break;
+                    i = (size_t) (nul - data);
+                    if (data[i + 1] == 0)
+                    {
+                        end = i + 2;
+                        break;
+                    }
+                }
+            }
+
+            count = (end > 0) ? end : size;
+            if (carry_.size() + count > maxStructure_)
+            {
+                state_ = STREAM_INVALID;
+                return size;
+            }
+            carry_.insert(carry_.end(), data, data + count);
+            if (end > 0)
+            {
+                emit(carry_.data(), carry_.size());
+                carry_.clear();
+            }
+            return count;
+        }
+    }
+
+    if (count > size) count = size;
+    carry_.insert(carry_.end(), data, data + count);
+    return count;
+}
+
+void StreamParser::emit( const uint8_t *data, size_t size )
+{
+    if (data[0] == DMI_TYPE_ENDOFTABLE)
+    {
+        state_ = STREAM_DONE;
+        return;
+    }
+
+    // 'Parser' reads no field past the formatted area, so the structure decodes where it is
+    // and gives the same entry it would in the whole table
+    Parser parser(data, size, version_, SMBIOS_FORMAT_TABLE);
+    const Entry *entry = parser.valid() ? parser.next() : NULL;
+    if (!parser.valid())
+    {
+        state_ = STREAM_INVALID;
+        return;
+    }
+
+    // the version 'Parser' settles on is the same it would use for the whole dump
+    version_ = parser.version();
+    ++structures_;
+    if (entry != NULL && handler_) handler_(*entry, Structure(data, size));
+}
+
+} // namespace smbios
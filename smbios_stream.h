@@ -0,0 +1,89 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SMBIOS_STREAM_HH
+#define SMBIOS_STREAM_HH
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <vector>
+#include "smbios.h"
+
+/*
+ * Push parser for dumps that arrive in pieces (pipes, sockets, archive
+ * streams). Chunks of any size are fed with 'push'; each structure is decoded
+ * by 'Parser' as soon as its string set is complete and handed to the
+ * handler, so the table is never held in memory as a whole.
+ *
+ * Structure boundaries are found in place in each chunk; only the structure
+ * that straddles a chunk boundary is carried over. Memory is bounded by the
+ * size of the largest structure ('maxStructure'), whatever the table size.
+ */
+
+namespace smbios {
+
+// Largest structure (formatted area and strings) accepted by default
+const size_t DMI_MAX_STRUCTURE_SIZE = 64 * 1024;
+
+// 'entry', 'structure' and the strings behind them are only valid during the call
+typedef std::function<void( const Entry &entry, const Structure &structure )> StructureHandler;
+
+class StreamParser
+{
+    public:
+        StreamParser( const StructureHandler &handler, int version = 0, int format = SMBIOS_FORMAT_AUTO,
+            size_t maxStructure = DMI_MAX_STRUCTURE_SIZE );
+
+        // Returns false once the stream turned out to be invalid (later chunks are ignored)
+        bool push( const uint8_t *data, size_t size );
+        // Ends the stream; false if it was invalid or stopped in the middle of a structure
+        bool finish();
+        void reset();
+
+        bool valid() const;
+        // true once the end-of-table structure (or the table length from the header) was reached
+        bool done() const;
+        // the detected (or given) input format and the version used to decode (0 until known)
+        int format() const;
+        int version() const;
+        size_t structures() const;
+
+    private:
+        StructureHandler handler_;
+        int requestedVersion_;
+        int requestedFormat_;
+        size_t maxStructure_;
+        int state_;
+        int version_;
+        int format_;
+        uint64_t remaining_;
+        size_t structures_;
+        // header bytes, then the structure split across chunks
+        std::vector<uint8_t> carry_;
+
+        // reads the input header from 'carry_' and starts on the table after it
+        bool beginTable( bool partial );
+        void consume( const uint8_t *data, size_t size );
+        size_t consumeInPlace( const uint8_t *data, size_t size );
+        size_t consumeCarried( const uint8_t *data, size_t size );
+        void emit( const uint8_t *data, size_t size );
+};
+
+} // namespace smbios
+
+#endif // SMBIOS_STREAM_HH
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "smbios_strings.h"
+#include <cstring>
+#ifndef SMBIOS_CORE
+#include <ostream>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SMBIOS_STRINGS_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace smbios {
+
+static inline bool isPrintable( unsigned char c )
+{
+    return c >= 0x20 && c < 0x7F;
+}
+
+// blanks, control bytes and the 0xFF filler some vendors pad strings with
+static inline bool isTrimmable( unsigned char c )
+{
+    return c <= 0x20 || c == 0x7F || c == 0xFF;
+}
+
+size_t findUnprintable( const char *str, size_t length )
+{
+    size_t i = 0;
+    #ifdef SMBIOS_STRINGS_SSE2
+    // as signed bytes, everything above 0x7F is negative, so a single 'less than 0x20'
+    // catches both control characters and non-ASCII bytes; DEL needs its own compare
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i del = _mm_set1_epi8(0x7F);
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*) (str + i));
+        __m128i bad = _mm_or_si128(_mm_cmplt_epi8(chunk, space), _mm_cmpeq_epi8(chunk, del));
+        int mask = _mm_movemask_epi8(bad);
+        if (mask != 0)
+        {
+            #ifdef _MSC_VER
+            unsigned long bit;
+            _BitScanForward(&bit, (unsigned long) mask);
+            return i + bit;
+            #else
+            return i + (size_t) __builtin_ctz((unsigned) mask);
+            #endif
+        }
+    }
+    #endif
+    for (; i < length; ++i)
+        if (!isPrintable((unsigned char) str[i])) return i;
+    return length;
+}
+
+SanitizedString sanitizeString( const char *str )
+{
+    if (str == NULL) return sanitizeString("", 0);
+    return sanitizeString(str, strlen(str));
+}
+
+SanitizedString sanitizeString( const char *str, size_t length )
+{
+    SanitizedString result;
+    result.flags = 0;
+
+    // scalar on purpose: the trim almost always stops at the first byte on each
+    // side, which is less than the setup of a vector compare would cost
+    const unsigned char *begin = (const unsigned char*) str;
+    const unsigned char *end = begin + length;
+    while (begin < end && isTrimmable(*begin)) ++begin;
+    while (end > begin && isTrimmable(end[-1])) --end;
+    if (begin != (const unsigned char*) str || end != (const unsigned char*) str + length)
+        result.flags |= STRING_TRIMMED;
+
+    result.data = (const char*) begin;
+    result.length = (size_t) (end - begin);
+
+    // classify only if the fast scan finds something (rare in well-behaved tables)
+    size_t pos = findUnprintable(result.data, result.length);
+    for (; pos < result.length; ++pos)
+    {
+        unsigned char c = (unsigned char) result.data[pos];
+        if (c >= 0x80)
+            result.flags |= STRING_NON_ASCII;
+        else
+        if (!isPrintable(c))
+            result.flags |= STRING_CONTROL;
+    }
+
+    return result;
+}
+
+#ifndef SMBIOS_CORE
+
+std::ostream &operator<<( std::ostream &output, const SanitizedString &str )
+{
+    if ((str.flags & (STRING_CONTROL | STRING_NON_ASCII)) == 0)
+        return output.write(str.data, (std::streamsize) str.length);
+
+    const char *ptr = str.data;
+    size_t length = str.length;
+    while (length > 0)
+    {
+        size_t pos = findUnprintable(ptr, length);
+        output.write(ptr, (std::streamsize) pos);
+        if (pos == length) break;
+        output.put('.');
+        ptr += pos + 1;
+        length -= pos + 1;
+    }
+    return output;
+}
+
+#endif // SMBIOS_CORE
+
+} // namespace smbios
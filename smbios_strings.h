@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SMBIOS_STRINGS_HH
+#define SMBIOS_STRINGS_HH
+
+#include <stddef.h>
+#ifndef SMBIOS_CORE
+#include <iosfwd>
+#endif
+
+namespace smbios {
+
+// set in 'SanitizedString::flags'
+const int STRING_TRIMMED   = 0x01;  // leading/trailing blanks, control bytes or 0xFF filler removed
+const int STRING_CONTROL   = 0x02;  // contains control characters
+const int STRING_NON_ASCII = 0x04;  // contains bytes above 0x7F (not valid ASCII)
+// 'emitSMBIOS' reports the last two after the field, as a "<key>_invalid:" line
+
+/*
+ * Non-owning view of an SMBIOS string with its edges trimmed. Characters that
+ * are not printable ASCII are replaced by '.' only when the view is written,
+ * so sanitizing never copies the string.
+ */
+struct SanitizedString
+{
+    const char *data;
+    size_t length;
+    int flags;
+};
+
+SanitizedString sanitizeString( const char *str );
+SanitizedString sanitizeString( const char *str, size_t length );
+
+/*
+ * Position of the first byte that is not printable ASCII (or 'length' if none).
+ * This scan is the only SSE2 part; the trim in 'sanitizeString' is scalar.
+ */
+size_t findUnprintable( const char *str, size_t length );
+
+#ifndef SMBIOS_CORE
+std::ostream &operator<<( std::ostream &output, const SanitizedString &str );
+#endif
+
+} // namespace smbios
+
+#endif // SMBIOS_STRINGS_HH
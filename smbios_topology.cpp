@@ -0,0 +1,144 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "smbios_topology.h"
+#include <algorithm>
+
+namespace smbios {
+
+uint16_t cacheWays( uint8_t associativity )
+{
+    static const uint16_t WAYS[] = { 0, 0, 0, 1, 2, 4, 0, 8, 16, 12, 24, 32, 48, 64, 20 };
+    return (associativity < sizeof(WAYS) / sizeof(WAYS[0])) ? WAYS[associativity] : 0;
+}
+
+namespace {
+
+struct CacheRecord
+{
+    uint16_t handle;
+    CacheInfo info;
+
+    bool operator<( const CacheRecord &that ) const { return handle < that.handle; }
+};
+
+struct ProcessorRecord
+{
+    SocketInfo socket;
+    uint16_t cacheHandles[DMI_CACHE_LEVELS];
+};
+
+}
+
+bool getTopology( const Parser &parser, Topology &topology )
+{
+    topology.sockets.clear();
+    topology.cores = topology.coresEnabled = topology.threads = 0;
+    if (!parser.valid()) return false;
+
+    int version = parser.version();
+    std::vector<CacheRecord> caches;
+    std::vector<ProcessorRecord> processors;
+
+    // processors may come before the caches they reference, so just collect both
+    Parser walker(parser.data(), parser.size(), version, SMBIOS_FORMAT_TABLE);
+    const Entry *entry = NULL;
+    while ((entry = walker.next()) != NULL)
+    {
+        if (entry->type == DMI_TYPE_CACHE)
+        {
+            const TypeCache &cache = entry->data.cache;
+            CacheRecord record;
+            record.handle = entry->handle;
+            record.info.handle = entry->handle;
+            record.info.level = (uint8_t) ((cache.CacheConfiguration & 0x07) + 1);
+            record.info.type = cache.SystemCacheType;
+            record.info.associativity = cache.Associativity;
+            record.info.ways = cacheWays(cache.Associativity);
+            record.info.size = cacheInstalledSize(cache);
+            record.info.sharedBy = 0;
+            caches.push_back(record);
+        }
+        else
+        if (entry->type == DMI_TYPE_PROCESSOR)
+        {
+            const TypeProcessor &proc = entry->data.processor;
+            ProcessorRecord record;
+            record.socket.handle = entry->handle;
+            record.socket.designation = proc.SocketDesignation;
+            record.socket.populated = (proc.Status & 0x40) != 0;
+            record.socket.cores = proc.CoreCount;
+            record.socket.coresEnabled = proc.CoreEnabled;
+            record.socket.threads = proc.ThreadCount;
+            // 0xFF means the actual value is in the 3.0+ 16-bit fields
+            if (version >= SMBIOS_3_0)
+            {
+                if (proc.CoreCount == 0xFF) record.socket.cores = proc.CoreCount2;
+                if (proc.CoreEnabled == 0xFF) record.socket.coresEnabled = proc.CoreEnabled2;
+                if (proc.ThreadCount == 0xFF) record.socket.threads = proc.ThreadCount2;
+            }
+            record.cacheHandles[0] = (version >= SMBIOS_2_1) ? proc.L1CacheHandle : DMI_INVALID_HANDLE;
+            record.cacheHandles[1] = (version >= SMBIOS_2_1) ? proc.L2CacheHandle : DMI_INVALID_HANDLE;
+            record.cacheHandles[2] = (version >= SMBIOS_2_1) ? proc.L3CacheHandle : DMI_INVALID_HANDLE;
+            processors.push_back(record);
+        }
+    }
+
+    if (processors.empty()) return false;
+
+    // resolve cache handles with a binary search over the sorted cache list
+    std::sort(caches.begin(), caches.end());
+    for (size_t i = 0; i < processors.size(); ++i)
+    {
+        for (int level = 0; level < DMI_CACHE_LEVELS; ++level)
+        {
+            CacheRecord key;
+            key.handle = processors[i].cacheHandles[level];
+            std::vector<CacheRecord>::iterator it = std::lower_bound(caches.begin(), caches.end(), key);
+            if (key.handle != DMI_INVALID_HANDLE && it != caches.end() && it->handle == key.handle)
+                ++it->info.sharedBy;
+        }
+    }
+
+    topology.sockets.reserve(processors.size());
+    for (size_t i = 0; i < processors.size(); ++i)
+    {
+        SocketInfo &socket = processors[i].socket;
+        for (int level = 0; level < DMI_CACHE_LEVELS; ++level)
+        {
+            CacheRecord key;
+            key.handle = processors[i].cacheHandles[level];
+            std::vector<CacheRecord>::iterator it = std::lower_bound(caches.begin(), caches.end(), key);
+            if (key.handle != DMI_INVALID_HANDLE && it != caches.end() && it->handle == key.handle)
+                socket.caches[level] = it->info;
+            else
+            {
+                memset(&socket.caches[level], 0, sizeof(CacheInfo));
+                socket.caches[level].handle = DMI_INVALID_HANDLE;
+                socket.caches[level].level = (uint8_t) (level + 1);
+            }
+        }
+        topology.cores += socket.cores;
+        topology.coresEnabled += socket.coresEnabled;
+        topology.threads += socket.threads;
+        topology.sockets.push_back(socket);
+    }
+
+    return true;
+}
+
+} // namespace smbios
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020 Bruno Ribeiro
+ * https://github.com/brunexgeek/smbios-parser
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SMBIOS_TOPOLOGY_HH
+#define SMBIOS_TOPOLOGY_HH
+
+#include <stdint.h>
+#include <vector>
+#include "smbios.h"
+
+namespace smbios {
+
+const uint16_t DMI_INVALID_HANDLE = 0xFFFF;
+const int DMI_CACHE_LEVELS = 3;
+
+// Cache referenced by a processor socket (resolved from a DMI_TYPE_CACHE structure)
+struct CacheInfo
+{
+    uint16_t handle;        // DMI_INVALID_HANDLE if the socket has no cache at this level
+    uint8_t level;          // 1-8
+    uint8_t type;           // system cache type (see 'cacheTypeName')
+    uint8_t associativity;  // raw value (see 'cacheAssociativityName')
+    uint16_t ways;          // 0 if unknown or fully associative
+    uint64_t size;          // installed size in KiB
+    uint16_t sharedBy;      // number of sockets referencing this cache
+};
+
+// Processor socket (DMI_TYPE_PROCESSOR) with its caches resolved
+struct SocketInfo
+{
+    uint16_t handle;
+    const char *designation;
+    bool populated;
+    uint16_t cores;
+    uint16_t coresEnabled;
+    uint16_t threads;
+    CacheInfo caches[DMI_CACHE_LEVELS];  // L1, L2 and L3
+};
+
+struct Topology
+{
+    std::vector<SocketInfo> sockets;
+    uint32_t cores;
+    uint32_t coresEnabled;
+    uint32_t threads;
+};
+
+// Number of ways for a cache associativity value (0 if unknown or fully associative)
+uint16_t cacheWays( uint8_t associativity );
+
+/*
+ * Builds the processor and cache topology in one walk over the table. The walk
+ * uses a parser of its own, so the position of 'parser' is left alone. Strings
+ * point into the parser buffer, which must outlive the result. Returns false
+ * if the parser is invalid or the table describes no processors.
+ */
+bool getTopology( const Parser &parser, Topology &topology );
+
+} // namespace smbios
+
+#endif // SMBIOS_TOPOLOGY_HH